@@ -0,0 +1,14 @@
+// builds 100k element lists by appending one element at a time
+let level = [];
+for (let i = 0; i < 100000; i = i + 1) {
+    level = push(level, i & 0xFF);
+}
+
+// every row is a slice of the level, joined back together
+let rows = [];
+for (let i = 0; i < 100000; i = i + 1000) {
+    rows = concat(rows, slice(level, i, 1000));
+}
+
+org 0x8000;
+db bytes(rows);
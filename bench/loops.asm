@@ -0,0 +1,10 @@
+// counted loops over a lazy range, nested to 1M iterations
+let sum = 0;
+for (y in range(1000)) {
+    for (x in range(1000)) {
+        sum = sum + (x ^ y);
+    }
+}
+
+org 0x8000;
+dd sum;
@@ -0,0 +1,31 @@
+// deep recursion. every call is in tail position
+fn count(n, acc) {
+    if (n == 0) {
+        return acc;
+    }
+    return count(n - 1, acc + 1);
+}
+
+// crc16 table generator written as a tail recursive loop
+fn crcbits(crc, bits) {
+    if (bits == 0) {
+        return crc;
+    }
+    if (crc & 0x8000) {
+        return crcbits(((crc << 1) ^ 0x1021) & 0xFFFF, bits - 1);
+    }
+    return crcbits((crc << 1) & 0xFFFF, bits - 1);
+}
+
+fn crctable(i) {
+    if (i == 256) {
+        return 0;
+    }
+    dw crcbits(i << 8, 8);
+    return crctable(i + 1);
+}
+
+org 0x8000;
+let total = count(500000, 0);
+dd total;
+crctable(0);
@@ -0,0 +1,20 @@
+#!/bin/sh
+# times lasm on every benchmark source
+# usage: bench/run.sh [path to lasm]
+
+LASM=${1:-./bin/lasm}
+DIR=$(dirname "$0")
+OUT=$(mktemp -d)
+
+for src in "$DIR"/*.asm; do
+    name=$(basename "$src" .asm)
+    start=$(date +%s.%N)
+    if ! "$LASM" -o "$OUT/$name.bin" "$src"; then
+        echo "$name: failed"
+        continue
+    fi
+    end=$(date +%s.%N)
+    echo "$name: $(echo "$end - $start" | bc) s"
+done
+
+rm -rf "$OUT"
@@ -5,10 +5,12 @@
 #include "argcc.h"
 #include "frontend.h"
 #include <fstream>
+#include <sstream>
 #include "instruction6502.h"
 #include "token.h"
 #include <filesystem>
 #include "colors.h"
+#include "memtrack.h"
 
 // TODO cross-platform?
 #include <unistd.h>
@@ -76,6 +78,14 @@ int main(int argc, char **argv) {
     parser.addArgument("-hprefix", liblc::STRING, 1, "Hex-prefix for symbols file", "-hp");
     parser.addArgument("-bprefix", liblc::STRING, 1, "Binary-prefix for symbols file", "-bp");
     parser.addArgument("-delim", liblc::STRING, 1, "Deliminator-prefix for symbols file", "-dp");
+    parser.addArgument("-stats", liblc::STRING, 1, "Cache statistics file", "-st");
+    parser.addArgument("-time-passes", liblc::STRING, 1, "Phase timing file", "-tp");
+    parser.addArgument("-time-format", liblc::STRING, 1, "Phase timing format (valid options: text, json)", "-tf");
+    parser.addArgument("-memstats", liblc::STRING, 1, "Allocations by subsystem file", "-ms");
+    parser.addArgument("-trace", liblc::STRING, 1, "Chrome trace of every phase", "-tr");
+    parser.addArgument("-profile", liblc::STRING, 1, "Profile of functions, loops and includes", "-pr");
+    parser.addArgument("-flamegraph", liblc::STRING, 1, "Profile as collapsed stacks", "-fg");
+    parser.addArgument("-plugin", liblc::STRING, 1, "Comma separated list of plugins", "-p");
     parser.addArgument("-cpu", liblc::STRING, 1, "CPU type (valid options: 6502, 65816, bf)", "-c");
 
     auto parsed = parser.parse(argc, argv);
@@ -117,6 +127,51 @@ int main(int argc, char **argv) {
         settings.delim = parsed.toString("-delim");
     }
 
+    if (parsed.containsAny("-stats")) {
+        settings.statsPath = parsed.toString("-stats");
+    }
+
+    if (parsed.containsAny("-time-passes")) {
+        settings.timingPath = parsed.toString("-time-passes");
+    }
+
+    if (parsed.containsAny("-time-format")) {
+        auto timeFormat = parsed.toString("-time-format");
+        if (timeFormat != "text" && timeFormat != "json") {
+            std::cerr << format.fred() << "Fatal: " << format.reset() << "Unknown timing format" << std::endl;
+            return -1;
+        }
+        settings.timingJson = timeFormat == "json";
+    }
+
+    if (parsed.containsAny("-memstats")) {
+        settings.memStatsPath = parsed.toString("-memstats");
+        if (!MemTracker::isEnabled()) {
+            std::cerr << format.fyellow() << "Warning: " << format.reset()
+                << "lasm was built without --enable-memtrack, allocations are not counted" << std::endl;
+        }
+    }
+
+    if (parsed.containsAny("-trace")) {
+        settings.tracePath = parsed.toString("-trace");
+    }
+
+    if (parsed.containsAny("-profile")) {
+        settings.profilePath = parsed.toString("-profile");
+    }
+
+    if (parsed.containsAny("-flamegraph")) {
+        settings.flameGraphPath = parsed.toString("-flamegraph");
+    }
+
+    if (parsed.containsAny("-plugin")) {
+        std::stringstream plugins(parsed.toString("-plugin"));
+        std::string plugin;
+        while (std::getline(plugins, plugin, ',')) {
+            settings.plugins.push_back(plugin);
+        }
+    }
+
     std::shared_ptr<BaseInstructionSet> instructions;
     try {
         instructions = makeInstructionSet(parseCpuType(cpuString));
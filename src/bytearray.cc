@@ -0,0 +1,84 @@
+#include "bytearray.h"
+#include <cstring>
+#include <algorithm>
+
+namespace lasm {
+    lasmNumber ByteArray::get(unsigned long index) {
+        lasmNumber value = 0;
+        auto element = data() + index * width;
+        for (unsigned short i = 0; i < width; i++) {
+            value |= (lasmNumber)element[i] << (i * 8);
+        }
+        return value;
+    }
+
+    void ByteArray::set(unsigned long index, lasmNumber value) {
+        detach();
+        auto element = data() + index * width;
+        for (unsigned short i = 0; i < width; i++) {
+            element[i] = (value >> (i * 8)) & 0xFF;
+        }
+    }
+
+    void ByteArray::push(lasmNumber value) {
+        detach();
+        storage->resize(offset + (length + 1) * width);
+        length++;
+        set(length - 1, value);
+    }
+
+    std::shared_ptr<ByteArray> ByteArray::slice(unsigned long start, unsigned long end) {
+        end = std::min(end, size());
+        start = std::min(start, end);
+        return std::shared_ptr<ByteArray>(new ByteArray(width, storage, offset + start * width, end - start));
+    }
+
+    std::shared_ptr<ByteArray> ByteArray::concat(ByteArray &other) {
+        auto result = std::make_shared<ByteArray>(width);
+        auto &bytes = *result->storage;
+        bytes.reserve((length + other.size()) * width);
+        bytes.insert(bytes.end(), data(), data() + length * width);
+        result->length = length;
+
+        if (other.width == width) {
+            bytes.insert(bytes.end(), other.data(), other.data() + other.length * width);
+            result->length += other.length;
+        } else {
+            for (unsigned long i = 0; i < other.size(); i++) {
+                result->push(other.get(i));
+            }
+        }
+        return result;
+    }
+
+    void ByteArray::detach() {
+        if (storage.use_count() == 1) {
+            return;
+        }
+
+        storage = std::make_shared<std::vector<unsigned char>>(data(), data() + length * width);
+        offset = 0;
+    }
+
+    void ByteArray::encode(char *out, unsigned short size, Endianess endianess) {
+        // same layout, no conversion needed
+        if (size == width && endianess != BIG) {
+            memcpy(out, data(), length * width);
+            return;
+        }
+
+        unsigned long length = this->size();
+        for (unsigned long i = 0; i < length; i++) {
+            auto value = get(i);
+            char *element = out + i * size;
+            for (unsigned short b = 0; b < size; b++) {
+                char byte = b < sizeof(lasmNumber) ? (value >> (b * 8)) & 0xFF : 0;
+                if (endianess == BIG) {
+                    element[size - 1 - b] = byte;
+                } else {
+                    element[b] = byte;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef __BYTEARRAY_H__
+#define __BYTEARRAY_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <stdexcept>
+#include "types.h"
+#include "object.h"
+
+namespace lasm {
+    /**
+     * Packed array of unsigned 8, 16 or 32 bit elements.
+     * Elements are stored little endian, width bytes each.
+     * Slices share their bytes with the original. A shared buffer is copied before it is written to
+     */
+    class ByteArray {
+        public:
+            ByteArray(unsigned short width=1, unsigned long length=0):
+                width(width), storage(std::make_shared<std::vector<unsigned char>>(byteSize(width, length), 0)),
+                length(length) {}
+
+            /**
+             * Array of bytes copied from data
+             */
+            ByteArray(const char *data, unsigned long length):
+                width(1), storage(std::make_shared<std::vector<unsigned char>>(data, data + length)),
+                length(length) {}
+
+            /**
+             * Array of bytes that takes over values
+             */
+            ByteArray(std::vector<unsigned char> &&values):
+                width(1), storage(std::make_shared<std::vector<unsigned char>>(std::move(values))),
+                length(storage->size()) {}
+
+            unsigned short getWidth() { return width; }
+
+            /**
+             * Elements as they are stored, size() * getWidth() bytes
+             */
+            const unsigned char* bytes() { return data(); }
+            unsigned long size() { return length; }
+
+            lasmNumber get(unsigned long index);
+            void set(unsigned long index, lasmNumber value);
+            void push(lasmNumber value);
+
+            /**
+             * Elements from start up to but excluding end. Shares the bytes of this array
+             */
+            std::shared_ptr<ByteArray> slice(unsigned long start, unsigned long end);
+
+            /**
+             * New array with the elements of both arrays in the width of this array
+             */
+            std::shared_ptr<ByteArray> concat(ByteArray &other);
+
+            /**
+             * Writes every element as a size byte value in the given byte order.
+             * out must hold size() * size bytes
+             */
+            void encode(char *out, unsigned short size, Endianess endianess);
+        private:
+            ByteArray(unsigned short width, std::shared_ptr<std::vector<unsigned char>> storage,
+                    unsigned long offset, unsigned long length):
+                width(width), storage(storage), offset(offset), length(length) {}
+
+            unsigned char* data() { return storage->data() + offset; }
+
+            /**
+             * Bytes of length elements. Throws std::length_error if they do not fit in a buffer
+             */
+            static unsigned long byteSize(unsigned short width, unsigned long length) {
+                if (width && length > std::vector<unsigned char>().max_size() / width) {
+                    throw std::length_error("ByteArray");
+                }
+                return length * width;
+            }
+
+            /**
+             * Moves the elements to a buffer of their own if another array shares them
+             */
+            void detach();
+
+            unsigned short width;
+            std::shared_ptr<std::vector<unsigned char>> storage;
+            // in bytes
+            unsigned long offset = 0;
+            // in elements
+            unsigned long length = 0;
+    };
+}
+
+#endif
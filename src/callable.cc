@@ -2,67 +2,413 @@
 #include "environment.h"
 #include "interpreter.h"
 #include "utility.h"
+#include "purity.h"
+#include "bytearray.h"
+#include "list.h"
+#include "dict.h"
+#include "range.h"
+#include <algorithm>
+
+// largest zero filled array bytes, array16 and array32 create
+#define ARRAY_MAX_LENGTH 0x1000000
 
 namespace lasm {
-    LasmObject LasmFunction::call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr) {
-        std::shared_ptr<Environment> env = std::make_shared<Environment>(Environment(interpreter->getEnv()));
+    /**
+     * Tracks how many lasm functions are active
+     */
+    class FunctionDepth {
+        public:
+            FunctionDepth(Interpreter *interpreter):
+                interpreter(interpreter) {
+                interpreter->enterFunction();
+            }
+            ~FunctionDepth() {
+                interpreter->leaveFunction();
+            }
+        private:
+            Interpreter *interpreter;
+    };
 
-        for (unsigned int i = 0; i < stmt->params.size(); i++) {
-            env->define(stmt->params[i]->getLexeme(), arguments[i]);
+    /**
+     * True if callee can not see any binding from inner up to and including frame
+     * because each of them is shadowed by one of its parameters.
+     * Without a callee every binding is visible
+     */
+    static bool isHidden(Environment *inner, Environment *frame, FunctionStmt *callee) {
+        for (auto env = inner; env; env = env->getParent().get()) {
+            for (auto &binding : env->getValues()) {
+                if (!callee || std::none_of(callee->params.begin(), callee->params.end(),
+                            [&binding](auto &param) { return param->getLexeme() == binding.first; })) {
+                    return false;
+                }
+            }
+            if (env == frame) {
+                return true;
+            }
         }
-        try {
-            interpreter->executeBlock(stmt->body, env);
-            return LasmObject(NIL_O, nullptr);
-        } catch (Return &e) {
-            return e.value;
-        } catch (LasmException &e) {
-            // wrap any exception inside a function in another esception to
-            // represent the call stack
-            throw CallStackUnwind(expr->paren, &e);
+        return false;
+    }
+
+    LasmObject LasmFunction::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        // pure functions are only run once per argument tuple
+        MemoTable *memo = nullptr;
+        Arguments key = arguments;
+        if (isPure(interpreter) && MemoTable::isCacheable(arguments)) {
+            LasmObject cached(NIL_O, nullptr);
+            if (stmt->memo.find(arguments, cached)) {
+                interpreter->onMemoHit();
+                return cached;
+            }
+            interpreter->onMemoMiss();
+            memo = &stmt->memo;
+        }
+
+        FunctionDepth depth(interpreter);
+        auto &tail = interpreter->getTailCall();
+
+        // tail calls replace the running function instead of nesting a new call
+        LasmFunction *function = this;
+        std::shared_ptr<Callable> current;
+        std::vector<LasmObject> next;
+        auto parent = interpreter->getEnv();
+        auto labelParent = interpreter->getLabels();
+
+        while (true) {
+            LASM_STAT_CALL(function->stmt->name->getLexeme());
+            CallbackScope scope(interpreter->getCallback(), function->stmt);
+            ScopedEnvironment env(interpreter->getEnvironmentPool(), parent);
+            ScopedEnvironment labels(interpreter->getEnvironmentPool(), labelParent);
+
+            try {
+                for (unsigned int i = 0; i < function->stmt->params.size(); i++) {
+                    interpreter->assertNotConstant(function->stmt->params[i]);
+                    env->define(function->stmt->params[i]->getLexeme(), arguments[i]);
+                }
+
+                interpreter->executeBlock(function->stmt->getBody(), env.get(), labels.get());
+            } catch (LasmException &e) {
+                // wrap any exception inside a function in another esception to
+                // represent the call stack
+                throw CallStackUnwind(expr->paren, &e);
+            }
+
+            if (!tail.isPending()) {
+                break;
+            }
+            // the return that deferred the call has no value of its own
+            interpreter->takeReturnValue();
+            current = tail.callee;
+            function = static_cast<LasmFunction*>(current.get());
+            expr = tail.expr;
+            // keep the arguments out of reach of the next body
+            next.swap(tail.arguments);
+            arguments = Arguments(next.data(), next.size());
+
+            // scopes are dynamic. the callee runs inside the scopes of the return
+            // unless its parameters hide everything the finished body defined
+            if (!isHidden(tail.environment.get(), env.get().get(), function->stmt)
+                    || !isHidden(tail.labels.get(), labels.get().get(), nullptr)) {
+                parent = tail.environment;
+                labelParent = tail.labels;
+            }
+            tail.clear();
+        }
+
+        auto result = interpreter->takeReturnValue();
+        if (memo && MemoTable::isCacheable(result)) {
+            memo->insert(key, result);
+        }
+        return result;
+    }
+
+    bool LasmFunction::isPure(Interpreter *interpreter) {
+        // callees are looked up again every pass
+        if (stmt->analyzedPass != interpreter->getPass()) {
+            // recursive analysis through other functions ends here
+            stmt->analyzedPass = interpreter->getPass();
+            stmt->analyzedPure = false;
+
+            // a cached call would not emit anything in later passes.
+            // pure fn is ignored if the body emits
+            PurityAnalyzer analyzer(interpreter);
+            if (stmt->pure) {
+                stmt->analyzedPure = !analyzer.emitsCode(stmt);
+            } else {
+                stmt->analyzedPure = analyzer.isPure(stmt);
+            }
         }
+        return stmt->analyzedPure;
     }
 
-    LasmObject NativeHi::call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr) {
-        auto num = arguments[0];
+    LasmObject NativeHi::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto &num = arguments[0];
         if (num.getType() != NUMBER_O) {
             return LasmObject(NIL_O, nullptr);
         }
         return LasmObject(NUMBER_O, LO(num.toNumber(), 8));
     }
 
-    LasmObject NativeLo::call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr) {
-        auto num = arguments[0];
+    LasmObject NativeLo::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto &num = arguments[0];
         if (num.getType() != NUMBER_O) {
             return LasmObject(NIL_O, nullptr);
         }
         return LasmObject(NUMBER_O, HI(num.toNumber(), 8));
     }
 
-    LasmObject NativeAddress::call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr) {
+    LasmObject NativeAddress::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
         return LasmObject(NUMBER_O, lasmNumber(interpreter->getAddress()));
     }
 
-    LasmObject NativeOrd::call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr) {
-        auto c = arguments[0];
+    LasmObject NativeOrd::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto &c = arguments[0];
         if (!c.isString() || c.toString().length() != 1) {
             return LasmObject(NIL_O, nullptr);
         }
         return LasmObject(NUMBER_O, lasmNumber(c.toString()[0]));
     }
 
-    LasmObject NativeLen::call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr) {
-        auto c = arguments[0];
+    LasmObject NativeLen::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto &c = arguments[0];
         if (c.isString()) {
-            return LasmObject(NUMBER_O, lasmNumber(c.toString().length()));
+            return LasmObject(NUMBER_O, lasmNumber(c.toLasmString()->length()));
+        } else if (c.isRange()) {
+            return LasmObject(NUMBER_O, lasmNumber(c.toRange()->size()));
         } else if (c.isList()) {
             return LasmObject(NUMBER_O, lasmNumber(c.toList()->size()));
+        } else if (c.isBytes()) {
+            return LasmObject(NUMBER_O, lasmNumber(c.toBytes()->size()));
+        } else if (c.isDict()) {
+            return LasmObject(NUMBER_O, lasmNumber(c.toDict()->size()));
         } else {
             return LasmObject(NIL_O, nullptr);
         }
     }
 
-    LasmObject NativeSetEnvName::call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr) {
-        auto c = arguments[0];
+    LasmObject NativeByteArray::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto &source = arguments[0];
+        std::shared_ptr<ByteArray> array;
+
+        if (source.isNumber()) {
+            if (source.toNumber() < 0 || source.toNumber() > ARRAY_MAX_LENGTH) {
+                throw LasmException(VALUE_OUT_OF_RANGE, expr->paren);
+            }
+            array = std::make_shared<ByteArray>(width, source.toNumber());
+        } else if (source.isString()) {
+            array = std::make_shared<ByteArray>(width);
+            for (auto c : source.toString()) {
+                array->push((unsigned char)c);
+            }
+        } else if (source.isList()) {
+            auto list = source.toList();
+            array = std::make_shared<ByteArray>(width, list->size());
+            for (unsigned long i = 0; i < list->size(); i++) {
+                auto &element = list->at(i);
+                if (!element.isNumber()) {
+                    throw LasmTypeError(std::vector<ObjectType> {NUMBER_O}, element.getType(), expr->paren);
+                }
+                array->set(i, element.toNumber());
+            }
+        } else if (source.isBytes()) {
+            ByteArray empty(width);
+            array = empty.concat(*source.toBytes());
+        } else {
+            throw LasmTypeError(std::vector<ObjectType> {NUMBER_O, STRING_O, LIST_O, BYTES_O},
+                    source.getType(), expr->paren);
+        }
+
+        return LasmObject(BYTES_O, array);
+    }
+
+    LasmObject NativeSlice::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto &value = arguments[0];
+        auto &start = arguments[1];
+        if (!start.isNumber() || (arguments.size() > 2 && !arguments[2].isNumber())) {
+            throw LasmTypeError(std::vector<ObjectType> {NUMBER_O},
+                    start.isNumber() ? arguments[2].getType() : start.getType(), expr->paren);
+        }
+        if (start.toNumber() < 0 || (arguments.size() > 2 && arguments[2].toNumber() < 0)) {
+            throw LasmException(VALUE_OUT_OF_RANGE, expr->paren);
+        }
+
+        // a missing length slices to the end of the value
+        unsigned long from = start.toNumber();
+        unsigned long to = arguments.size() > 2 ? from + arguments[2].toNumber() : (unsigned long)-1;
+        if (value.isList()) {
+            return LasmObject(LIST_O, value.toList()->slice(from, to));
+        } else if (value.isBytes()) {
+            return LasmObject(BYTES_O, value.toBytes()->slice(from, to));
+        } else if (value.isString()) {
+            return LasmObject(STRING_O, LasmString::slice(value.toLasmString(), from, to));
+        }
+        throw LasmTypeError(std::vector<ObjectType> {STRING_O, LIST_O, BYTES_O}, value.getType(), expr->paren);
+    }
+
+    LasmObject NativeReadBin::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto &path = arguments[0];
+        if (!path.isString()) {
+            throw LasmTypeError(std::vector<ObjectType> {STRING_O}, path.getType(), expr->paren);
+        }
+
+        auto reader = interpreter->getReader();
+        if (!reader) {
+            return LasmObject(BYTES_O, std::make_shared<ByteArray>());
+        }
+
+        auto &file = files[path.toString()];
+        if (!file.get()) {
+            auto stream = reader->openFile(path.toString());
+            unsigned long size = 0;
+            auto data = reader->readFullFile(stream, &size);
+            reader->closeFile(stream);
+            file = std::make_shared<ByteArray>(data.get(), size);
+        }
+
+        // a view, so writing to the result does not change the cached file
+        return LasmObject(BYTES_O, file->slice(0, file->size()));
+    }
+
+    LasmObject BufferCallable::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto &source = arguments[0];
+        std::vector<unsigned char> out;
+        try {
+            transformArgument(source, arguments, expr, out);
+        } catch (LasmException &e) {
+            // transforms do not know the call they are part of
+            if (!e.getToken().get()) {
+                throw LasmException(e.getType(), expr->paren);
+            }
+            throw;
+        }
+        return LasmObject(BYTES_O, std::make_shared<ByteArray>(std::move(out)));
+    }
+
+    void BufferCallable::transformArgument(LasmObject &source, Arguments &arguments, CallExpr *expr,
+            std::vector<unsigned char> &out) {
+        if (source.isBytes()) {
+            auto array = source.toBytes();
+            transform(array->bytes(), array->size() * array->getWidth(), arguments, out);
+        } else if (source.isString()) {
+            auto &str = source.toString();
+            transform((const unsigned char*)str.data(), str.length(), arguments, out);
+        } else if (source.isList()) {
+            auto list = source.toList();
+            std::vector<unsigned char> data;
+            data.reserve(list->size());
+            for (auto &element : *list) {
+                if (!element.isNumber()) {
+                    throw LasmTypeError(std::vector<ObjectType> {NUMBER_O}, element.getType(), expr->paren);
+                }
+                data.push_back(element.toNumber() & 0xFF);
+            }
+            transform(data.data(), data.size(), arguments, out);
+        } else {
+            throw LasmTypeError(std::vector<ObjectType> {BYTES_O, STRING_O, LIST_O}, source.getType(), expr->paren);
+        }
+    }
+
+    LasmObject NativePush::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto &list = arguments[0];
+        if (!list.isList()) {
+            throw LasmTypeError(std::vector<ObjectType> {LIST_O}, list.getType(), expr->paren);
+        }
+        return LasmObject(LIST_O, list.toList()->push(arguments[1]));
+    }
+
+    LasmObject NativeConcat::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto &a = arguments[0];
+        auto &b = arguments[1];
+        if (a.isList() && b.isList()) {
+            return LasmObject(LIST_O, a.toList()->concat(*b.toList()));
+        } else if (a.isBytes() && b.isBytes()) {
+            return LasmObject(BYTES_O, a.toBytes()->concat(*b.toBytes()));
+        }
+        throw LasmTypeError(std::vector<ObjectType> {LIST_O, BYTES_O},
+                a.isList() || a.isBytes() ? b.getType() : a.getType(), expr->paren);
+    }
+
+    /**
+     * Checks that arguments[0] is a dict and arguments[1] a valid key
+     */
+    static std::shared_ptr<LasmDict> dictArgument(Arguments arguments, CallExpr *expr) {
+        auto &dict = arguments[0];
+        if (!dict.isDict()) {
+            throw LasmTypeError(std::vector<ObjectType> {DICT_O}, dict.getType(), expr->paren);
+        }
+        if (arguments.size() > 1 && !LasmDict::isKey(arguments[1])) {
+            throw LasmTypeError(std::vector<ObjectType> {NUMBER_O, STRING_O}, arguments[1].getType(), expr->paren);
+        }
+        return dict.toDict();
+    }
+
+    LasmObject NativeDict::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto dict = std::make_shared<LasmDict>();
+        if (arguments.size() == 0) {
+            return LasmObject(DICT_O, dict);
+        }
+
+        auto &pairs = arguments[0];
+        if (!pairs.isList()) {
+            throw LasmTypeError(std::vector<ObjectType> {LIST_O}, pairs.getType(), expr->paren);
+        }
+        for (auto &pair : *pairs.toList()) {
+            if (!pair.isList() || pair.toList()->size() != 2) {
+                throw LasmTypeError(std::vector<ObjectType> {LIST_O}, pair.getType(), expr->paren);
+            }
+            auto &key = pair.toList()->at(0);
+            if (!LasmDict::isKey(key)) {
+                throw LasmTypeError(std::vector<ObjectType> {NUMBER_O, STRING_O}, key.getType(), expr->paren);
+            }
+            dict->set(key, pair.toList()->at(1));
+        }
+        return LasmObject(DICT_O, dict);
+    }
+
+    LasmObject NativeHas::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        return LasmObject(BOOLEAN_O, dictArgument(arguments, expr)->find(arguments[1]) != nullptr);
+    }
+
+    LasmObject NativeKeys::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        return LasmObject(LIST_O, dictArgument(arguments, expr)->keys());
+    }
+
+    LasmObject NativeRemove::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        return LasmObject(BOOLEAN_O, dictArgument(arguments, expr)->remove(arguments[1]));
+    }
+
+    LasmObject NativeJoin::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto &list = arguments[0];
+        if (!list.isList()) {
+            throw LasmTypeError(std::vector<ObjectType> {LIST_O}, list.getType(), expr->paren);
+        }
+        if (arguments.size() > 1 && !arguments[1].isString()) {
+            throw LasmTypeError(std::vector<ObjectType> {STRING_O}, arguments[1].getType(), expr->paren);
+        }
+
+        size_t length = 0;
+        for (auto &element : *list.toList()) {
+            if (!element.isString()) {
+                throw LasmTypeError(std::vector<ObjectType> {STRING_O}, element.getType(), expr->paren);
+            }
+            length += element.toLasmString()->length();
+        }
+
+        std::string separator = arguments.size() > 1 ? arguments[1].toString() : "";
+        std::string result;
+        result.reserve(length + separator.length() * list.toList()->size());
+        bool first = true;
+        for (auto &element : *list.toList()) {
+            if (!first) {
+                result += separator;
+            }
+            result += element.toString();
+            first = false;
+        }
+        return LasmObject(STRING_O, result);
+    }
+
+    LasmObject NativeSetEnvName::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto &c = arguments[0];
         interpreter->getEnv()->setName(c.toString());
         interpreter->getLabels()->setName(c.toString());
         return LasmObject(NIL_O, nullptr);
@@ -5,32 +5,38 @@
 #include <any>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 #include "object.h"
 #include "stmt.h"
+#include "callframe.h"
 
 namespace lasm {
     class Interpreter;
 
-    class Return {
-        public:
-            Return(LasmObject value):
-                value(value) {}
-
-            LasmObject value;
-    };
-
     class Callable {
         public:
             Callable(unsigned short arity=0):
-                arity(arity) {}
+                arity(arity), maxArity(arity) {}
+            /**
+             * Callable that takes between arity and maxArity arguments
+             */
+            Callable(unsigned short arity, unsigned short maxArity):
+                arity(arity), maxArity(maxArity) {}
             virtual ~Callable() {}
-            virtual LasmObject call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr) {
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
                 return LasmObject(NIL_O, nullptr);
             }
 
             unsigned short getArity() { return arity; }
+            unsigned short getMaxArity() { return maxArity; }
+
+            /**
+             * A pure callable only depends on its arguments
+             */
+            virtual bool isPure(Interpreter *interpreter) { return false; }
         private:
             unsigned short arity = 0;
+            unsigned short maxArity = 0;
     };
 
     class LasmFunction: public Callable {
@@ -38,7 +44,10 @@ namespace lasm {
             LasmFunction(FunctionStmt *stmt):
                 Callable::Callable(stmt->params.size()), stmt(stmt) {}
 
-            virtual LasmObject call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr);
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter);
+
+            FunctionStmt* getStmt() { return stmt; }
         private:
             FunctionStmt *stmt;
     };
@@ -49,7 +58,8 @@ namespace lasm {
                 Callable::Callable(1) {}
             ~NativeHi() {}
 
-            virtual LasmObject call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr);
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
     };
 
     class NativeLo: public Callable {
@@ -58,7 +68,8 @@ namespace lasm {
                 Callable::Callable(1) {}
             ~NativeLo() {}
 
-            virtual LasmObject call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr);
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
     };
 
     class NativeAddress: public Callable {
@@ -67,7 +78,7 @@ namespace lasm {
                 Callable::Callable(0) {}
             ~NativeAddress() {}
 
-            virtual LasmObject call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr);
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
     };
 
     class NativeOrd: public Callable {
@@ -76,7 +87,8 @@ namespace lasm {
                 Callable::Callable(1) {}
             ~NativeOrd() {}
 
-            virtual LasmObject call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr);
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
     };
 
     class NativeLen: public Callable {
@@ -85,7 +97,159 @@ namespace lasm {
                 Callable::Callable(1) {}
             ~NativeLen() {}
 
-            virtual LasmObject call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr);
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    /**
+     * bytes, array16 and array32.
+     * Builds a packed array from a length, string, list or other array
+     */
+    class NativeByteArray: public Callable {
+        public:
+            NativeByteArray(unsigned short width):
+                Callable::Callable(1), width(width) {}
+            ~NativeByteArray() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+        private:
+            unsigned short width;
+    };
+
+    class NativeSlice: public Callable {
+        public:
+            NativeSlice():
+                Callable::Callable(2, 3) {}
+            ~NativeSlice() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    /**
+     * readbin(path). Contents of a binary file as a byte array.
+     * Every file is only read once
+     */
+    class NativeReadBin: public Callable {
+        public:
+            NativeReadBin():
+                Callable::Callable(1) {}
+            ~NativeReadBin() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+        private:
+            std::unordered_map<std::string, std::shared_ptr<ByteArray>> files;
+    };
+
+    /**
+     * Builtin that transforms a block of bytes natively.
+     * The first argument is an array, string or list of numbers. The bytes of arrays and strings
+     * are passed without copying them, arrays with wider elements are passed as their little endian bytes.
+     * The bytes written to out are returned as a byte array
+     */
+    class BufferCallable: public Callable {
+        public:
+            BufferCallable(unsigned short arity=1):
+                Callable::Callable(arity) {}
+            BufferCallable(unsigned short arity, unsigned short maxArity):
+                Callable::Callable(arity, maxArity) {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+
+            /**
+             * arguments still holds every argument, including the buffer.
+             * A LasmException without a token is reported at the call
+             */
+            virtual void transform(const unsigned char *data, unsigned long length,
+                    Arguments &arguments, std::vector<unsigned char> &out) = 0;
+
+            // transforms only depend on their arguments unless they say otherwise
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+        private:
+            void transformArgument(LasmObject &source, Arguments &arguments, CallExpr *expr,
+                    std::vector<unsigned char> &out);
+    };
+
+    /**
+     * push(list, value). New list with value appended
+     */
+    class NativePush: public Callable {
+        public:
+            NativePush():
+                Callable::Callable(2) {}
+            ~NativePush() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    /**
+     * concat(a, b). New list or array with the elements of a and b
+     */
+    class NativeConcat: public Callable {
+        public:
+            NativeConcat():
+                Callable::Callable(2) {}
+            ~NativeConcat() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    /**
+     * dict([pairs]). New dict, optionally filled from a list of [key, value] lists
+     */
+    class NativeDict: public Callable {
+        public:
+            NativeDict():
+                Callable::Callable(0, 1) {}
+            ~NativeDict() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    class NativeHas: public Callable {
+        public:
+            NativeHas():
+                Callable::Callable(2) {}
+            ~NativeHas() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    class NativeKeys: public Callable {
+        public:
+            NativeKeys():
+                Callable::Callable(1) {}
+            ~NativeKeys() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    class NativeRemove: public Callable {
+        public:
+            NativeRemove():
+                Callable::Callable(2) {}
+            ~NativeRemove() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+    };
+
+    /**
+     * join(list[, separator]). Concatenates a list of strings in one step
+     */
+    class NativeJoin: public Callable {
+        public:
+            NativeJoin():
+                Callable::Callable(1, 2) {}
+            ~NativeJoin() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
     };
 
     class NativeSetEnvName: public Callable {
@@ -94,7 +258,7 @@ namespace lasm {
                 Callable::Callable(1) {}
             ~NativeSetEnvName() {}
 
-            virtual LasmObject call(Interpreter *interpreter, std::vector<LasmObject> arguments, CallExpr *expr);
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
     };
 }
 
@@ -0,0 +1,63 @@
+#include "callframe.h"
+#include "memtrack.h"
+#include <algorithm>
+
+namespace lasm {
+    LasmObject* ArgumentStack::push(unsigned long count) {
+        marks.push_back(Mark(block, top, count));
+
+        if (blocks.size() == 0) {
+            blocks.push_back(std::vector<LasmObject>(blockSize, LasmObject(NIL_O, nullptr)));
+        }
+
+        if (top + count > blocks[block].size()) {
+            // continue in the next block. blocks after the current one are unused
+            block++;
+            top = 0;
+            if (block == blocks.size()) {
+                blocks.push_back(std::vector<LasmObject>(std::max(count, blockSize), LasmObject(NIL_O, nullptr)));
+            } else if (blocks[block].size() < count) {
+                blocks[block] = std::vector<LasmObject>(count, LasmObject(NIL_O, nullptr));
+            }
+        }
+
+        auto slots = blocks[block].data() + top;
+        top += count;
+        return slots;
+    }
+
+    void ArgumentStack::pop() {
+        auto mark = marks.back();
+        marks.pop_back();
+
+        // drop references held by the arguments
+        auto slots = blocks[block].data() + top - mark.count;
+        for (unsigned long i = 0; i < mark.count; i++) {
+            slots[i] = LasmObject(NIL_O, nullptr);
+        }
+
+        block = mark.block;
+        top = mark.top;
+    }
+
+    std::shared_ptr<Environment> EnvironmentPool::acquire(std::shared_ptr<Environment> parent) {
+        MemTracker::Scope memory(MEM_ENVIRONMENT);
+        if (top == pool.size()) {
+            pool.push_back(std::make_shared<Environment>(Environment(parent)));
+        } else if (pool[top].use_count() > 1) {
+            pool[top] = std::make_shared<Environment>(Environment(parent));
+        } else {
+            pool[top]->reset(parent);
+        }
+        return pool[top++];
+    }
+
+    void EnvironmentPool::release() {
+        top--;
+        // an unused parent link would keep the parent from being recycled.
+        // a captured environment still needs its chain for lookups
+        if (pool[top].use_count() == 1) {
+            pool[top]->setParent(std::shared_ptr<Environment>(nullptr));
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef __CALLFRAME_H__
+#define __CALLFRAME_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "object.h"
+#include "environment.h"
+
+namespace lasm {
+    class Callable;
+    class CallExpr;
+
+    /**
+     * Non-owning view of the arguments of a call.
+     * The slots belong to the interpreter's argument stack
+     * and are only valid for the duration of the call.
+     */
+    class Arguments {
+        public:
+            Arguments(LasmObject *slots=nullptr, unsigned long count=0):
+                slots(slots), count(count) {}
+
+            LasmObject& operator[](unsigned long index) { return slots[index]; }
+            unsigned long size() { return count; }
+
+            LasmObject* begin() { return slots; }
+            LasmObject* end() { return slots+count; }
+        private:
+            LasmObject *slots;
+            unsigned long count;
+    };
+
+    /**
+     * Stack of argument slots.
+     * Slots are handed out from fixed size blocks that are never moved,
+     * so a view stays valid while nested calls push their own arguments.
+     * Blocks are kept once allocated.
+     */
+    class ArgumentStack {
+        public:
+            LasmObject* push(unsigned long count);
+            void pop();
+        private:
+            class Mark {
+                public:
+                    Mark(unsigned long block, unsigned long top, unsigned long count):
+                        block(block), top(top), count(count) {}
+                    unsigned long block;
+                    unsigned long top;
+                    unsigned long count;
+            };
+
+            std::vector<std::vector<LasmObject>> blocks;
+            std::vector<Mark> marks;
+            unsigned long block = 0;
+            unsigned long top = 0;
+
+            static constexpr unsigned long blockSize = 256;
+    };
+
+    /**
+     * Reserves count slots for the lifetime of the frame
+     */
+    class ArgumentFrame {
+        public:
+            ArgumentFrame(ArgumentStack &stack, unsigned long count):
+                stack(stack), slots(stack.push(count)), count(count) {}
+            ~ArgumentFrame() {
+                stack.pop();
+            }
+
+            LasmObject& operator[](unsigned long index) { return slots[index]; }
+            Arguments getArguments() { return Arguments(slots, count); }
+        private:
+            ArgumentStack &stack;
+            LasmObject *slots;
+            unsigned long count;
+    };
+
+    /**
+     * Recycles the environments of blocks and calls.
+     * Scopes are strictly nested, so environments are handed out like a stack.
+     * An environment that is still referenced after its scope was left
+     * (e.g. by a label lookup of the first pass) is replaced instead of reused.
+     */
+    class EnvironmentPool {
+        public:
+            std::shared_ptr<Environment> acquire(std::shared_ptr<Environment> parent);
+            void release();
+        private:
+            std::vector<std::shared_ptr<Environment>> pool;
+            unsigned long top = 0;
+    };
+
+    /**
+     * A call in tail position that is executed by the calling function
+     * once the current body was left.
+     */
+    class TailCall {
+        public:
+            bool isPending() { return callee.get() != nullptr; }
+
+            void clear() {
+                callee.reset();
+                environment.reset();
+                labels.reset();
+            }
+
+            std::shared_ptr<Callable> callee;
+            CallExpr *expr = nullptr;
+            std::vector<LasmObject> arguments;
+
+            // scopes of the return that deferred the call
+            std::shared_ptr<Environment> environment;
+            std::shared_ptr<Environment> labels;
+    };
+
+    class ScopedEnvironment {
+        public:
+            ScopedEnvironment(EnvironmentPool &pool, std::shared_ptr<Environment> parent):
+                pool(pool), env(pool.acquire(parent)) {}
+            ~ScopedEnvironment() {
+                env.reset();
+                pool.release();
+            }
+
+            std::shared_ptr<Environment>& get() { return env; }
+            Environment* operator->() { return env.get(); }
+        private:
+            EnvironmentPool &pool;
+            std::shared_ptr<Environment> env;
+    };
+}
+
+#endif
@@ -1,4 +1,6 @@
 #include "codewriter.h"
+#include <iomanip>
+#include <sstream>
 
 namespace lasm {
     void BinaryWriter::write(std::string path) {
@@ -14,8 +16,17 @@ namespace lasm {
         // TODO also dump a mapping of code to addresses
         auto sos = writer.openFile(path);
 
-        for (auto env : interpreter.getLabelTable()) {
-            outputSymbolsEnvironment(writer, sos, env);
+        outputSymbolsEnvironment(writer, sos, interpreter.getGlobalLabels());
+
+        // every other label scope was compacted into the symbol table
+        auto &table = interpreter.getSymbolTable();
+        std::string root = interpreter.getGlobalLabels()->getName();
+        for (auto &symbol : table.getSymbols()) {
+            std::string name = table.qualify(symbol.name, symbol.scope, delim);
+            if (root != "") {
+                name = root + delim + name;
+            }
+            outputSymbol(*(sos.get()), name, symbol.value);
         }
         outputSymbolsEnvironment(writer, sos, interpreter.getGlobals());
         writer.closeFile(sos);
@@ -41,20 +52,182 @@ namespace lasm {
                 parent = parent->getParent();
             }
 
-            switch (obj->getType()) {
-                case STRING_O:
-                    stream << name << " = " << obj->toString() << std::endl;
-                    break;
-                case NUMBER_O:
-                    stream << name << " = " << hexPrefix << std::hex << obj->toNumber() << std::endl;
-                    break;
-                case REAL_O:
-                    stream << name << " = " << obj->toReal() << std::endl;
-                    break;
-                default:
-                    // skip
-                    break;
+            outputSymbol(stream, name, *obj);
+        }
+    }
+
+    void SymbolsWriter::outputSymbol(std::ostream &stream, std::string name, LasmObject &obj) {
+        switch (obj.getType()) {
+            case STRING_O:
+                stream << name << " = " << obj.toString() << std::endl;
+                break;
+            case NUMBER_O:
+                stream << name << " = " << hexPrefix << std::hex << obj.toNumber() << std::endl;
+                break;
+            case REAL_O:
+                stream << name << " = " << obj.toReal() << std::endl;
+                break;
+            default:
+                // skip
+                break;
+        }
+    }
+
+    void StatsWriter::write(std::string path) {
+        auto os = writer.openFile(path);
+        std::ostream &stream = *(os.get());
+
+        auto &cache = interpreter.getExpressionCache();
+        stream << "expression_cache_hits = " << std::dec << cache.getHits() << std::endl;
+        stream << "expression_cache_misses = " << cache.getMisses() << std::endl;
+        stream << "expression_cache_entries = " << cache.size() << std::endl;
+        stream << "memo_hits = " << interpreter.getMemoHits() << std::endl;
+        stream << "memo_misses = " << interpreter.getMemoMisses() << std::endl;
+
+#ifdef LASM_STATS
+        stream << "environment_gets = " << Stats::environmentGets << std::endl;
+        stream << "environment_average_depth = "
+            << (Stats::environmentGets ? (double)Stats::environmentHops / Stats::environmentGets : 0) << std::endl;
+        stream << "undefined_references = " << Stats::undefinedReferences << std::endl;
+        stream << "object_copies = " << Stats::objectCopies << std::endl;
+        stream << "instruction_results = " << Stats::instructionResults << std::endl;
+        stream << "instruction_bytes = " << Stats::instructionBytes << std::endl;
+        stream << "loop_iterations = " << Stats::loopIterations << std::endl;
+        for (auto &call : Stats::calls) {
+            stream << "calls." << call.first << " = " << call.second << std::endl;
+        }
+#endif
+
+        writer.closeFile(os);
+    }
+
+    void TimingWriter::write(std::string path) {
+        auto os = writer.openFile(path);
+        std::ostream &stream = *(os.get());
+
+        if (json) {
+            writeJson(stream);
+        } else {
+            writeText(stream);
+        }
+
+        writer.closeFile(os);
+    }
+
+    void TimingWriter::writeText(std::ostream &stream) {
+        stream << std::left << std::setw(12) << "phase" << std::setw(24) << "file"
+            << std::right << std::setw(12) << "wall (s)" << std::setw(12) << "cpu (s)"
+            << std::setw(8) << "count" << std::endl;
+
+        stream << std::fixed << std::setprecision(6);
+        for (auto &phase : timer.getPhases()) {
+            stream << std::left << std::setw(12) << phase.name << std::setw(24) << phase.file
+                << std::right << std::setw(12) << phase.wall << std::setw(12) << phase.cpu
+                << std::setw(8) << phase.count << std::endl;
+        }
+        stream << "peak_rss_kb = " << PhaseTimer::getPeakRss() << std::endl;
+    }
+
+    static std::string jsonString(const std::string &value) {
+        std::stringstream escaped;
+        escaped << '"';
+        for (unsigned char c : value) {
+            if (c == '"' || c == '\\') {
+                escaped << '\\' << c;
+            } else if (c < 0x20) {
+                escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec;
+            } else {
+                escaped << c;
             }
         }
+        escaped << '"';
+        return escaped.str();
+    }
+
+    void TimingWriter::writeJson(std::ostream &stream) {
+        stream << "{\"phases\": [";
+        bool first = true;
+        for (auto &phase : timer.getPhases()) {
+            if (!first) {
+                stream << ", ";
+            }
+            first = false;
+            stream << "{\"name\": " << jsonString(phase.name)
+                << ", \"file\": " << jsonString(phase.file)
+                << ", \"wall\": " << phase.wall
+                << ", \"cpu\": " << phase.cpu
+                << ", \"count\": " << phase.count << "}";
+        }
+        stream << "], \"peak_rss_kb\": " << PhaseTimer::getPeakRss() << "}" << std::endl;
+    }
+
+    void MemStatsWriter::write(std::string path) {
+        // taken before the file adds its own allocations
+        MemTracker::Counter counters[MEM_TAG_COUNT];
+        for (int tag = 0; tag < MEM_TAG_COUNT; tag++) {
+            counters[tag] = MemTracker::get((MemTag)tag);
+        }
+
+        auto os = writer.openFile(path);
+        std::ostream &stream = *(os.get());
+
+        for (int tag = 0; tag < MEM_TAG_COUNT; tag++) {
+            auto name = MemTracker::tagToString((MemTag)tag);
+            auto &counter = counters[tag];
+            stream << name << ".allocations = " << counter.allocations << std::endl;
+            stream << name << ".bytes = " << counter.bytes << std::endl;
+            stream << name << ".peak_bytes = " << counter.peak << std::endl;
+            stream << name << ".live_bytes = " << counter.live << std::endl;
+        }
+
+        writer.closeFile(os);
+    }
+
+    void TraceWriter::write(std::string path) {
+        auto os = writer.openFile(path);
+        std::ostream &stream = *(os.get());
+
+        auto &phases = timer.getPhases();
+        stream << "{\"traceEvents\": [";
+        stream << std::fixed << std::setprecision(3);
+        bool first = true;
+        for (auto &span : timer.getSpans()) {
+            if (!first) {
+                stream << "," << std::endl;
+            }
+            first = false;
+
+            auto &phase = phases[span.phase];
+            // complete events in microseconds
+            stream << "{\"name\": " << jsonString(phase.name)
+                << ", \"cat\": \"lasm\", \"ph\": \"X\""
+                << ", \"ts\": " << span.start * 1000000
+                << ", \"dur\": " << span.duration * 1000000
+                << ", \"pid\": 1, \"tid\": 1"
+                << ", \"args\": {\"file\": " << jsonString(phase.file) << "}}";
+        }
+        stream << "], \"displayTimeUnit\": \"ms\"}" << std::endl;
+
+        writer.closeFile(os);
+    }
+
+    void ProfileWriter::write(std::string path) {
+        auto os = writer.openFile(path);
+        std::ostream &stream = *(os.get());
+
+        if (collapsed) {
+            profiler.writeCollapsed(stream);
+        } else {
+            stream << std::right << std::setw(14) << "exclusive (s)" << std::setw(14) << "inclusive (s)"
+                << std::setw(10) << "calls" << "  name" << std::endl;
+
+            stream << std::fixed << std::setprecision(6);
+            for (auto &entry : profiler.getEntries()) {
+                stream << std::setw(14) << entry.exclusive << std::setw(14) << entry.inclusive
+                    << std::setw(10) << entry.calls << "  " << entry.name << std::endl;
+            }
+        }
+
+        writer.closeFile(os);
     }
 }
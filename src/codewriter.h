@@ -9,6 +9,9 @@
 #include "filewriter.h"
 #include "interpreter.h"
 #include "environment.h"
+#include "phasetimer.h"
+#include "profiler.h"
+#include "memtrack.h"
 
 namespace lasm {
     class CodeWriter {
@@ -47,10 +50,89 @@ namespace lasm {
             virtual void write(std::string path);
         private:
             void outputSymbolsEnvironment(FileWriter &writer, std::shared_ptr<std::ostream> os, std::shared_ptr<Environment> env);
+            void outputSymbol(std::ostream &stream, std::string name, LasmObject &obj);
             Interpreter &interpreter;
             std::string hexPrefix;
             std::string delim;
     };
+
+    /**
+     * Dumps how well the interpreter caches worked
+     * in format <name> = <value>
+     */
+    class StatsWriter: public CodeWriter {
+        public:
+            StatsWriter(FileWriter &writer, Interpreter &interpreter):
+                CodeWriter::CodeWriter(writer), interpreter(interpreter) {
+                }
+
+            virtual void write(std::string path);
+        private:
+            Interpreter &interpreter;
+    };
+
+    /**
+     * Dumps the time of every phase and the peak memory use
+     * as a table or as json
+     */
+    class TimingWriter: public CodeWriter {
+        public:
+            TimingWriter(FileWriter &writer, PhaseTimer &timer, bool json=false):
+                CodeWriter::CodeWriter(writer), timer(timer), json(json) {
+                }
+
+            virtual void write(std::string path);
+        private:
+            void writeText(std::ostream &stream);
+            void writeJson(std::ostream &stream);
+
+            PhaseTimer &timer;
+            bool json;
+    };
+
+    /**
+     * Dumps the allocations of every subsystem
+     * in format <subsystem>.<counter> = <value>
+     */
+    class MemStatsWriter: public CodeWriter {
+        public:
+            MemStatsWriter(FileWriter &writer):
+                CodeWriter::CodeWriter(writer) {
+                }
+
+            virtual void write(std::string path);
+    };
+
+    /**
+     * Dumps every run of a phase in the chrome trace event format.
+     * The file can be opened in chrome://tracing or perfetto
+     */
+    class TraceWriter: public CodeWriter {
+        public:
+            TraceWriter(FileWriter &writer, PhaseTimer &timer):
+                CodeWriter::CodeWriter(writer), timer(timer) {
+                }
+
+            virtual void write(std::string path);
+        private:
+            PhaseTimer &timer;
+    };
+
+    /**
+     * Dumps the profile of functions, loops and includes as a table
+     * or as collapsed stacks for flame graph tools
+     */
+    class ProfileWriter: public CodeWriter {
+        public:
+            ProfileWriter(FileWriter &writer, Profiler &profiler, bool collapsed=false):
+                CodeWriter::CodeWriter(writer), profiler(profiler), collapsed(collapsed) {
+                }
+
+            virtual void write(std::string path);
+        private:
+            Profiler &profiler;
+            bool collapsed;
+    };
 }
 
 #endif
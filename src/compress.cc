@@ -0,0 +1,274 @@
+#include "compress.h"
+#include "bytearray.h"
+#include "list.h"
+#include "dict.h"
+#include <algorithm>
+
+// control bytes shared by every format
+#define PACK_MAX_LITERALS 0x80
+#define PACK_END 0xFF
+
+#define RLE_MIN_RUN 2
+#define RLE_MAX_RUN (PACK_END - 1 - 0x80 + RLE_MIN_RUN)
+
+#define LZ_MIN_MATCH 3
+#define LZ_MAX_MATCH (PACK_END - 1 - 0x80 + LZ_MIN_MATCH)
+#define LZ_MAX_DISTANCE 0xFFFF
+// candidates that are compared before the longest match so far is taken
+#define LZ_MAX_CHAIN 256
+#define LZ_HASH_BITS 15
+
+namespace lasm {
+    /**
+     * Writes data[start] to data[end] as literal blocks
+     */
+    static void packLiterals(const unsigned char *data, unsigned long start, unsigned long end,
+            std::vector<unsigned char> &out) {
+        while (start < end) {
+            auto count = std::min(end - start, (unsigned long)PACK_MAX_LITERALS);
+            out.push_back(count - 1);
+            out.insert(out.end(), data + start, data + start + count);
+            start += count;
+        }
+    }
+
+    /**
+     * Reads the literal block at data[i] if there is one.
+     * Throws VALUE_OUT_OF_RANGE if the data ends early
+     */
+    static bool unpackLiterals(const unsigned char *data, unsigned long length, unsigned long &i,
+            std::vector<unsigned char> &out) {
+        unsigned long count = data[i] + 1;
+        if (data[i] >= PACK_MAX_LITERALS) {
+            return false;
+        } else if (i + count >= length) {
+            throw LasmException(VALUE_OUT_OF_RANGE);
+        }
+        out.insert(out.end(), data + i + 1, data + i + 1 + count);
+        i += count + 1;
+        return true;
+    }
+
+    void NativePackRle::transform(const unsigned char *data, unsigned long length,
+            Arguments &arguments, std::vector<unsigned char> &out) {
+        unsigned long literals = 0;
+        unsigned long i = 0;
+        while (i < length) {
+            unsigned long run = 1;
+            while (i + run < length && run < RLE_MAX_RUN && data[i + run] == data[i]) {
+                run++;
+            }
+
+            // a run of two is not shorter than two literals
+            if (run > RLE_MIN_RUN) {
+                packLiterals(data, literals, i, out);
+                out.push_back(0x80 + run - RLE_MIN_RUN);
+                out.push_back(data[i]);
+                literals = i + run;
+            }
+            i += run;
+        }
+        packLiterals(data, literals, length, out);
+        out.push_back(PACK_END);
+    }
+
+    /**
+     * True if data[i] is the end of the data
+     */
+    static bool unpackEnd(const unsigned char *data, unsigned long length, unsigned long i) {
+        if (i >= length) {
+            throw LasmException(VALUE_OUT_OF_RANGE);
+        }
+        return data[i] == PACK_END;
+    }
+
+    void NativeUnpackRle::transform(const unsigned char *data, unsigned long length,
+            Arguments &arguments, std::vector<unsigned char> &out) {
+        unsigned long i = 0;
+        while (!unpackEnd(data, length, i)) {
+            if (unpackLiterals(data, length, i, out)) {
+                continue;
+            } else if (i + 1 >= length) {
+                throw LasmException(VALUE_OUT_OF_RANGE);
+            }
+            out.insert(out.end(), data[i] - 0x80 + RLE_MIN_RUN, data[i + 1]);
+            i += 2;
+        }
+    }
+
+    static unsigned long lzHash(const unsigned char *data) {
+        unsigned long value = data[0] | (data[1] << 8) | (data[2] << 16);
+        return ((value * 2654435761UL) & 0xFFFFFFFF) >> (32 - LZ_HASH_BITS);
+    }
+
+    void NativePackLz::transform(const unsigned char *data, unsigned long length,
+            Arguments &arguments, std::vector<unsigned char> &out) {
+        // most recent position of every hashed 3 byte prefix and the position before it
+        std::vector<long> head(1 << LZ_HASH_BITS, -1);
+        std::vector<long> previous(length, -1);
+        auto insert = [&](unsigned long at) {
+            if (at + LZ_MIN_MATCH <= length) {
+                auto hash = lzHash(data + at);
+                previous[at] = head[hash];
+                head[hash] = at;
+            }
+        };
+
+        unsigned long literals = 0;
+        unsigned long i = 0;
+        while (i < length) {
+            unsigned long best = 0;
+            unsigned long distance = 0;
+            if (i + LZ_MIN_MATCH <= length) {
+                auto max = std::min(length - i, (unsigned long)LZ_MAX_MATCH);
+                auto candidate = head[lzHash(data + i)];
+                for (int tries = 0; candidate != -1 && i - candidate <= LZ_MAX_DISTANCE && tries < LZ_MAX_CHAIN;
+                        tries++, candidate = previous[candidate]) {
+                    unsigned long matched = 0;
+                    while (matched < max && data[candidate + matched] == data[i + matched]) {
+                        matched++;
+                    }
+                    if (matched > best) {
+                        best = matched;
+                        distance = i - candidate;
+                        if (matched == max) {
+                            break;
+                        }
+                    }
+                }
+            }
+
+            // a match of the shortest length is not smaller than the literals it replaces
+            if (best > LZ_MIN_MATCH) {
+                packLiterals(data, literals, i, out);
+                out.push_back(0x80 + best - LZ_MIN_MATCH);
+                out.push_back(distance & 0xFF);
+                out.push_back(distance >> 8);
+                for (unsigned long end = i + best; i < end; i++) {
+                    insert(i);
+                }
+                literals = i;
+            } else {
+                insert(i);
+                i++;
+            }
+        }
+        packLiterals(data, literals, length, out);
+        out.push_back(PACK_END);
+    }
+
+    void NativeUnpackLz::transform(const unsigned char *data, unsigned long length,
+            Arguments &arguments, std::vector<unsigned char> &out) {
+        unsigned long i = 0;
+        while (!unpackEnd(data, length, i)) {
+            if (unpackLiterals(data, length, i, out)) {
+                continue;
+            } else if (i + 2 >= length) {
+                throw LasmException(VALUE_OUT_OF_RANGE);
+            }
+
+            unsigned long count = data[i] - 0x80 + LZ_MIN_MATCH;
+            unsigned long distance = data[i + 1] | (data[i + 2] << 8);
+            if (distance == 0 || distance > out.size()) {
+                throw LasmException(VALUE_OUT_OF_RANGE);
+            }
+            // copied one byte at a time, a match may overlap itself
+            for (unsigned long k = 0; k < count; k++) {
+                out.push_back(out[out.size() - distance]);
+            }
+            i += 3;
+        }
+    }
+
+    LasmObject NativePackDte::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        for (unsigned long i = 1; i < arguments.size(); i++) {
+            if (!arguments[i].isNumber()) {
+                throw LasmTypeError(std::vector<ObjectType> {NUMBER_O}, arguments[i].getType(), expr->paren);
+            }
+        }
+        lasmNumber first = arguments.size() > 1 ? arguments[1].toNumber() : 0x80;
+        lasmNumber count = arguments.size() > 2 ? arguments[2].toNumber() : 0x100 - first;
+        if (first < 0 || count < 0 || first + count > 0x100) {
+            throw LasmException(VALUE_OUT_OF_RANGE, expr->paren);
+        }
+
+        // every string is packed with the same table
+        std::vector<std::vector<unsigned char>> texts;
+        auto &source = arguments[0];
+        auto addText = [&](LasmObject &text) {
+            if (!text.isString()) {
+                throw LasmTypeError(std::vector<ObjectType> {STRING_O}, text.getType(), expr->paren);
+            }
+            auto &str = text.toString();
+            texts.push_back(std::vector<unsigned char>(str.begin(), str.end()));
+            for (auto c : texts.back()) {
+                if (c >= first) {
+                    throw LasmException(VALUE_OUT_OF_RANGE, expr->paren);
+                }
+            }
+        };
+        if (source.isList()) {
+            for (auto &text : *source.toList()) {
+                addText(text);
+            }
+        } else {
+            addText(source);
+        }
+
+        std::vector<unsigned char> table;
+        std::vector<unsigned long> pairs(0x10000);
+        for (lasmNumber code = first; code < first + count; code++) {
+            // pairs are only made of characters, so every code expands to two characters
+            std::fill(pairs.begin(), pairs.end(), 0);
+            for (auto &text : texts) {
+                for (unsigned long i = 0; i + 1 < text.size(); i++) {
+                    if (text[i] < first && text[i + 1] < first) {
+                        pairs[(text[i] << 8) | text[i + 1]]++;
+                    }
+                }
+            }
+
+            auto best = std::max_element(pairs.begin(), pairs.end());
+            // the table entry costs two bytes
+            if (*best < 3) {
+                break;
+            }
+            unsigned char a = (best - pairs.begin()) >> 8;
+            unsigned char b = (best - pairs.begin()) & 0xFF;
+            table.push_back(a);
+            table.push_back(b);
+
+            for (auto &text : texts) {
+                unsigned long to = 0;
+                for (unsigned long from = 0; from < text.size(); from++) {
+                    if (from + 1 < text.size() && text[from] == a && text[from + 1] == b) {
+                        text[to++] = code;
+                        from++;
+                    } else {
+                        text[to++] = text[from];
+                    }
+                }
+                text.resize(to);
+            }
+        }
+
+        auto result = std::make_shared<LasmDict>();
+        LasmObject tableKey(STRING_O, std::string("table"));
+        LasmObject tableValue(BYTES_O, std::make_shared<ByteArray>(std::move(table)));
+        result->set(tableKey, tableValue);
+
+        LasmObject textKey(STRING_O, std::string("text"));
+        LasmObject textValue(NIL_O, nullptr);
+        if (source.isList()) {
+            std::vector<LasmObject> packed;
+            for (auto &text : texts) {
+                packed.push_back(LasmObject(BYTES_O, std::make_shared<ByteArray>(std::move(text))));
+            }
+            textValue = LasmObject(LIST_O, std::make_shared<LasmList>(std::move(packed)));
+        } else {
+            textValue = LasmObject(BYTES_O, std::make_shared<ByteArray>(std::move(texts[0])));
+        }
+        result->set(textKey, textValue);
+        return LasmObject(DICT_O, result);
+    }
+}
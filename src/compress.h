@@ -0,0 +1,59 @@
+#ifndef __COMPRESS_H__
+#define __COMPRESS_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "callable.h"
+
+namespace lasm {
+    /**
+     * Native compressors.
+     * Both formats are byte oriented and share their control bytes:
+     * 0x00-0x7F: the next n+1 bytes are copied as they are
+     * 0xFF: end of data
+     */
+
+    // pack_rle(data). 0x80-0xFE: the next byte is repeated n-0x80+2 times
+    class NativePackRle: public BufferCallable {
+        public:
+            virtual void transform(const unsigned char *data, unsigned long length,
+                    Arguments &arguments, std::vector<unsigned char> &out);
+    };
+
+    // unpack_rle(data)
+    class NativeUnpackRle: public BufferCallable {
+        public:
+            virtual void transform(const unsigned char *data, unsigned long length,
+                    Arguments &arguments, std::vector<unsigned char> &out);
+    };
+
+    // pack_lz(data). 0x80-0xFE: copies n-0x80+3 bytes that were already written.
+    // A 16 bit little endian distance back from the end of the output follows
+    class NativePackLz: public BufferCallable {
+        public:
+            virtual void transform(const unsigned char *data, unsigned long length,
+                    Arguments &arguments, std::vector<unsigned char> &out);
+    };
+
+    // unpack_lz(data)
+    class NativeUnpackLz: public BufferCallable {
+        public:
+            virtual void transform(const unsigned char *data, unsigned long length,
+                    Arguments &arguments, std::vector<unsigned char> &out);
+    };
+
+    // pack_dte(text[, first[, count]]).
+    // Replaces the most common pairs of characters with the codes first to first+count-1
+    class NativePackDte: public Callable {
+        public:
+            NativePackDte():
+                Callable::Callable(1, 3) {}
+            ~NativePackDte() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+}
+
+#endif
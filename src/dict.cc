@@ -0,0 +1,79 @@
+#include "dict.h"
+#include "list.h"
+
+namespace lasm {
+    long LasmDict::indexOf(LasmObject &key, size_t hash) {
+        auto range = index.equal_range(hash);
+        for (auto it = range.first; it != range.second; it++) {
+            if (entries[it->second].key.isEqual(key)) {
+                return it->second;
+            }
+        }
+        return -1;
+    }
+
+    LasmObject* LasmDict::find(LasmObject &key) {
+        auto i = indexOf(key, key.hash());
+        if (i == -1) {
+            return nullptr;
+        }
+        return &entries[i].value;
+    }
+
+    void LasmDict::set(LasmObject &key, LasmObject &value) {
+        auto hash = key.hash();
+        auto i = indexOf(key, hash);
+        if (i != -1) {
+            entries[i].value = value;
+            return;
+        }
+
+        index.insert(std::make_pair(hash, entries.size()));
+        entries.push_back(Entry(key, value));
+        live++;
+    }
+
+    bool LasmDict::remove(LasmObject &key) {
+        auto range = index.equal_range(key.hash());
+        for (auto it = range.first; it != range.second; it++) {
+            auto &entry = entries[it->second];
+            if (entry.key.isEqual(key)) {
+                entry.removed = true;
+                entry.value = LasmObject(NIL_O, nullptr);
+                index.erase(it);
+                live--;
+                compact();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::shared_ptr<LasmList> LasmDict::keys() {
+        std::vector<LasmObject> values;
+        values.reserve(live);
+        for (auto &entry : entries) {
+            if (!entry.removed) {
+                values.push_back(entry.key);
+            }
+        }
+        return std::make_shared<LasmList>(std::move(values));
+    }
+
+    void LasmDict::compact() {
+        if (entries.size() - live <= live) {
+            return;
+        }
+
+        std::vector<Entry> kept;
+        kept.reserve(live);
+        index.clear();
+        for (auto &entry : entries) {
+            if (!entry.removed) {
+                index.insert(std::make_pair(entry.key.hash(), kept.size()));
+                kept.push_back(entry);
+            }
+        }
+        entries.swap(kept);
+    }
+}
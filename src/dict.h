@@ -0,0 +1,65 @@
+#ifndef __DICT_H__
+#define __DICT_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include "object.h"
+
+namespace lasm {
+    class LasmList;
+
+    /**
+     * Value of a dict object.
+     * Maps numbers and strings to values. Keys keep the order they were inserted in
+     */
+    class LasmDict {
+        public:
+            static bool isKey(LasmObject &key) {
+                return key.isNumber() || key.isString();
+            }
+
+            /**
+             * Value of key or nullptr if key is not in the dict
+             */
+            LasmObject* find(LasmObject &key);
+
+            void set(LasmObject &key, LasmObject &value);
+
+            /**
+             * Returns false if key was not in the dict
+             */
+            bool remove(LasmObject &key);
+
+            unsigned long size() { return live; }
+
+            std::shared_ptr<LasmList> keys();
+        private:
+            /**
+             * Index into entries or -1
+             */
+            long indexOf(LasmObject &key, size_t hash);
+
+            /**
+             * Drops removed entries once they outnumber the live ones
+             */
+            void compact();
+
+            class Entry {
+                public:
+                    Entry(LasmObject key, LasmObject value):
+                        key(key), value(value) {}
+
+                    LasmObject key;
+                    LasmObject value;
+                    bool removed = false;
+            };
+
+            std::vector<Entry> entries;
+            std::unordered_multimap<size_t, unsigned long> index;
+            unsigned long live = 0;
+    };
+}
+
+#endif
@@ -1,20 +1,66 @@
 #include "environment.h"
+#include "stats.h"
+#include "memtrack.h"
 
 namespace lasm {
-    void Environment::define(std::string name, LasmObject &value) {
+    Environment::~Environment() {
+        // scopes kept alive by tail calls form long chains.
+        // release them without recursing through every parent
+        auto next = std::move(parent);
+        while (next.get() && next.use_count() == 1) {
+            auto after = std::move(next->parent);
+            next = std::move(after);
+        }
+    }
+
+    void Environment::define(const std::string &name, LasmObject &value) {
+        MemTracker::Scope memory(MEM_ENVIRONMENT);
+        auto it = values.find(name);
+        if (it != values.end()) {
+            // the previous value may still be referenced elsewhere
+            if (it->second.use_count() == 1) {
+                *it->second = value;
+            } else {
+                it->second = std::make_shared<LasmObject>(LasmObject(value));
+            }
+            return;
+        } else if (!unbound.empty()) {
+            // reuse a binding of a previous use of this environment
+            auto node = std::move(unbound.back());
+            unbound.pop_back();
+            node.key() = name;
+            if (node.mapped()) {
+                *node.mapped() = value;
+            } else {
+                node.mapped() = std::make_shared<LasmObject>(LasmObject(value));
+            }
+            values.insert(std::move(node));
+            return;
+        }
         values[name] = std::make_shared<LasmObject>(LasmObject(value));
     }
 
+    void Environment::defineConstant(const std::string &name, LasmObject &value) {
+        MemTracker::Scope memory(MEM_ENVIRONMENT);
+        define(name, value);
+        constants.insert(name);
+    }
+
     std::shared_ptr<LasmObject> Environment::get(std::shared_ptr<Token> name) {
-        auto it = values.find(name->getLexeme());
-        if (it == values.end()) {
-            if (parent.get()) {
-                return parent->get(name);
+        LASM_STAT(environmentGets);
+        auto env = this;
+        while (true) {
+            auto it = env->values.find(name->getLexeme());
+            if (it != env->values.end()) {
+                return it->second;
             }
-            throw LasmUndefinedReference(name);
+            if (!env->parent.get()) {
+                LASM_STAT(undefinedReferences);
+                throw LasmUndefinedReference(name);
+            }
+            env = env->parent.get();
+            LASM_STAT(environmentHops);
         }
-
-        return it->second;
     }
 
     void Environment::assign(std::shared_ptr<Token> name, LasmObject &value) {
@@ -24,12 +70,34 @@ namespace lasm {
                 parent->assign(name, value);
                 return;
             }
+            LASM_STAT(undefinedReferences);
             throw LasmUndefinedReference(name);
+        } else if (isConstant(name->getLexeme())) {
+            throw LasmException(CONST_ASSIGNMENT, name);
         }
         define(name->getLexeme(), value);
     }
 
     void Environment::clear() {
         values.clear();
+        constants.clear();
+    }
+
+    void Environment::reset(std::shared_ptr<Environment> parent) {
+        while (!values.empty()) {
+            auto node = values.extract(values.begin());
+            if (node.mapped().use_count() == 1) {
+                *node.mapped() = LasmObject(NIL_O, nullptr);
+            } else {
+                // still referenced elsewhere, do not touch the value
+                node.mapped() = nullptr;
+            }
+            unbound.push_back(std::move(node));
+        }
+        constants.clear();
+        this->parent = parent;
+        name = "";
+        scopeOrder = 0;
+        symbolScope = -1;
     }
 }
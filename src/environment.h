@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <set>
 #include "object.h"
 #include "token.h"
 #include "error.h"
@@ -16,7 +17,18 @@ namespace lasm {
         public:
             Environment(std::shared_ptr<Environment> parent=std::shared_ptr<Environment>(nullptr)):
                 parent(parent) {}
-            void define(std::string name, LasmObject &value);
+            Environment(Environment &&other) = default;
+            ~Environment();
+
+            void define(const std::string &name, LasmObject &value);
+
+            /**
+             * Defines a binding that can not be assigned
+             */
+            void defineConstant(const std::string &name, LasmObject &value);
+            bool isConstant(const std::string &name) {
+                return !constants.empty() && constants.find(name) != constants.end();
+            }
 
             std::shared_ptr<LasmObject> get(std::shared_ptr<Token> name);
             void assign(std::shared_ptr<Token> name, LasmObject &value);
@@ -26,6 +38,12 @@ namespace lasm {
 
             void clear();
 
+            /**
+             * Prepares the environment for reuse.
+             * Bindings are unbound, but their storage is kept for the next define
+             */
+            void reset(std::shared_ptr<Environment> parent);
+
             std::map<std::string, std::shared_ptr<LasmObject>>& getValues() { return values; }
 
             std::string getName() {
@@ -35,12 +53,27 @@ namespace lasm {
             void setName(std::string newName) {
                 name = newName;
             }
+
+            unsigned long getScopeOrder() { return scopeOrder; }
+            void setScopeOrder(unsigned long order) { scopeOrder = order; }
+
+            long getSymbolScope() { return symbolScope; }
+            void setSymbolScope(long scope) { symbolScope = scope; }
         private:
             std::map<std::string, std::shared_ptr<LasmObject>> values;
+            std::vector<std::map<std::string, std::shared_ptr<LasmObject>>::node_type> unbound;
             std::shared_ptr<Environment> parent = std::shared_ptr<Environment>(nullptr);
 
+            // names of bindings that are constant
+            std::set<std::string> constants;
+
             // env's name. only used for label export
             std::string name = "";
+
+            // position in execution order and index in the symbol table.
+            // only used for label export
+            unsigned long scopeOrder = 0;
+            long symbolScope = -1;
     };
 }
 
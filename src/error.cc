@@ -47,6 +47,16 @@ namespace lasm {
                 return "File not found";
             case CALLSTACK_UNWIND:
                 return "Stack trace";
+            case MISSING_FUNCTION:
+                return "Expected 'fn'";
+            case CONST_ASSIGNMENT:
+                return "Assignment to constant";
+            case CONST_REDEFINITION:
+                return "Redefinition of constant";
+            case CONST_WITHOUT_VALUE:
+                return "Constant without value";
+            case PLUGIN_ERROR:
+                return "Plugin could not be loaded";
             default:
                 return "";
         }
@@ -69,6 +79,12 @@ namespace lasm {
                 return "callable";
             case LIST_O:
                 return "list";
+            case BYTES_O:
+                return "bytes";
+            case DICT_O:
+                return "dict";
+            case RANGE_O:
+                return "range";
             case BOOLEAN_O:
                 return "boolean";
 
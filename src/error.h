@@ -33,7 +33,12 @@ namespace lasm {
         INDEX_OUT_OF_BOUNDS,
         FILE_NOT_FOUND,
         CALLSTACK_UNWIND,
-        BAD_CPU_TYPE
+        BAD_CPU_TYPE,
+        MISSING_FUNCTION,
+        CONST_ASSIGNMENT,
+        CONST_REDEFINITION,
+        CONST_WITHOUT_VALUE,
+        PLUGIN_ERROR
     } ErrorType;
 
     std::string errorToString(ErrorType error);
@@ -100,6 +100,11 @@ namespace lasm {
             void setEnv(unsigned long address, std::shared_ptr<Environment> env);
 
             std::shared_ptr<Token> name;
+
+            // global constant this variable resolved to and the pass it was resolved in.
+            // constants can not be shadowed, so the lookup is only done once per pass
+            std::shared_ptr<LasmObject> constant = std::shared_ptr<LasmObject>(nullptr);
+            long constantPass = -1;
         private:
             // is non-null if variable literal points to a label name
             // labels mapping address, label enviormnet
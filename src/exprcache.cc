@@ -0,0 +1,51 @@
+#include "exprcache.h"
+#include "memo.h"
+
+// evaluations that may miss in a row before an entry is given up
+#define EXPRESSION_CACHE_MAX_MISSES 4
+
+namespace lasm {
+    bool ExpressionDependency::matches(LasmObject *current) {
+        if (!resolved || !current) {
+            return !resolved && !current;
+        }
+
+        if (value.getType() != current->getType()) {
+            return false;
+        }
+
+        if (value.isCallable()) {
+            return value.toCallable().get() == current->toCallable().get();
+        }
+        return value.isEqual(*current);
+    }
+
+    bool ExpressionCache::isCandidate(Expr *expr) {
+        switch (expr->getType()) {
+            case BINARY_EXPR:
+            case UNARY_EXPR:
+            case GROUPING_EXPR:
+            case CALL_EXPR:
+                return true;
+            case INDEX_EXPR:
+                return !dynamic_cast<IndexAssignExpr*>(expr);
+            default:
+                return false;
+        }
+    }
+
+    void ExpressionCache::store(Entry &entry, std::vector<ExpressionDependency> &dependencies,
+            LasmObject &result, bool cacheable) {
+        entry.misses++;
+        if (!cacheable || !MemoTable::isCacheable(result) || entry.misses > EXPRESSION_CACHE_MAX_MISSES) {
+            entry.disabled = true;
+            entry.valid = false;
+            entry.dependencies.clear();
+            return;
+        }
+
+        entry.dependencies = dependencies;
+        entry.result = result;
+        entry.valid = true;
+    }
+}
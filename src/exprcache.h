@@ -0,0 +1,79 @@
+#ifndef __EXPRCACHE_H__
+#define __EXPRCACHE_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include "object.h"
+#include "expr.h"
+
+namespace lasm {
+    /**
+     * A variable an expression read while it was evaluated and the value it had
+     */
+    class ExpressionDependency {
+        public:
+            ExpressionDependency(VariableExpr *expr, LasmObject *value):
+                expr(expr), resolved(value != nullptr),
+                value(value ? *value : LasmObject(NIL_O, nullptr)) {}
+
+            /**
+             * True if current is the same binding state that was recorded.
+             * Callables compare by identity, unresolved names only match unresolved names
+             */
+            bool matches(LasmObject *current);
+
+            VariableExpr *expr;
+            // false if the name was not resolved yet
+            bool resolved;
+            LasmObject value;
+    };
+
+    /**
+     * Values of expressions by the variables they depend on.
+     * An expression that only reads unchanged variables and calls pure functions
+     * evaluates to the same value again, independent of the pass or address
+     */
+    class ExpressionCache {
+        public:
+            class Entry {
+                public:
+                    std::vector<ExpressionDependency> dependencies;
+                    LasmObject result = LasmObject(NIL_O, nullptr);
+                    bool valid = false;
+                    bool disabled = false;
+                    unsigned long misses = 0;
+            };
+
+            /**
+             * Literals and plain variables are cheaper to evaluate than to look up.
+             * Assignments and lists are never cached
+             */
+            static bool isCandidate(Expr *expr);
+
+            Entry& get(Expr *expr) { return entries[expr]; }
+
+            /**
+             * Stores a recorded evaluation. An entry that keeps changing is disabled
+             */
+            void store(Entry &entry, std::vector<ExpressionDependency> &dependencies,
+                    LasmObject &result, bool cacheable);
+
+            void onHit() { hits++; }
+            void onMiss() { misses++; }
+
+            unsigned long getHits() { return hits; }
+            unsigned long getMisses() { return misses; }
+            unsigned long size() { return entries.size(); }
+
+            void clear() { entries.clear(); }
+        private:
+            std::unordered_map<Expr*, Entry> entries;
+
+            unsigned long hits = 0;
+            unsigned long misses = 0;
+    };
+}
+
+#endif
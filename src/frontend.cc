@@ -7,6 +7,8 @@
 #include "instructionbf.h"
 #include <string>
 #include "codewriter.h"
+#include "optimizer.h"
+#include "memtrack.h"
 
 namespace lasm {
     CpuType parseCpuType(std::string input) {
@@ -40,50 +42,141 @@ namespace lasm {
     int Frontend::assemble(std::string inPath, std::string outPath, std::string symbolPath) {
         auto previousPath = reader.getDir();
 
+        Stats::reset();
+        MemTracker::reset();
+
+        PhaseTimer timer(settings.tracePath != "");
+        PhaseTimer *phases = settings.timingPath != "" || settings.tracePath != "" ? &timer : nullptr;
+
         FrontendErrorHandler error(errorOut, settings.format);
-        std::shared_ptr<std::istream> is;
-        try {
-            is = reader.openFile(inPath);
-        } catch (LasmException &e) {
-            error.onError(e.getType(), 0, inPath, &e);
-            return e.getType();
-        }
-        reader.changeDir(inPath, true);
+        std::string source;
+        {
+            PhaseTimer::Scope phase(phases, "read", inPath);
+            MemTracker::Scope memory(MEM_SCANNER);
+            std::shared_ptr<std::istream> is;
+            try {
+                is = reader.openFile(inPath);
+            } catch (LasmException &e) {
+                error.onError(e.getType(), 0, inPath, &e);
+                return e.getType();
+            }
+            reader.changeDir(inPath, true);
 
-        auto buffer = reader.readFullFile(is);
-        // now we have the entire file read
-        std::string source(buffer.get());
-        reader.closeFile(is);
+            auto buffer = reader.readFullFile(is);
+            // now we have the entire file read
+            source = std::string(buffer.get());
+            reader.closeFile(is);
+        }
 
-        Scanner scanner(error, instructions, source, inPath);
-        auto tokens = scanner.scanTokens();
+        std::vector<std::shared_ptr<Token>> tokens;
+        {
+            PhaseTimer::Scope phase(phases, "scan", inPath);
+            MemTracker::Scope memory(MEM_SCANNER);
+            Scanner scanner(error, instructions, source, inPath);
+            tokens = scanner.scanTokens();
+        }
 
         if (error.didError()) {
             return error.getType();
         }
-        Parser parser(error, tokens, instructions);
-        auto ast = parser.parse();
+        std::vector<std::shared_ptr<Stmt>> ast;
+        {
+            PhaseTimer::Scope phase(phases, "parse", inPath);
+            MemTracker::Scope memory(MEM_PARSER);
+            Parser parser(error, tokens, instructions);
+            ast = parser.parse();
+        }
 
         if (error.didError()) {
             return error.getType();
         }
-        Interpreter interpreter(error, instructions, nullptr, &reader);
 
-        auto binary = interpreter.interprete(ast, true);
+        {
+            PhaseTimer::Scope phase(phases, "optimize", inPath);
+            MemTracker::Scope memory(MEM_PARSER);
+            Optimizer optimizer(error, instructions);
+            optimizer.optimize(ast);
+        }
+        Profiler profiler;
+        bool profile = settings.profilePath != "" || settings.flameGraphPath != "";
+
+        Interpreter interpreter(error, instructions, profile ? &profiler : nullptr, &reader);
+        interpreter.setTimer(phases);
+        for (auto &path : settings.plugins) {
+            try {
+                plugins.load(path, interpreter);
+            } catch (LasmException &e) {
+                error.onError(e.getType(), 0, path, &e);
+                errorOut << plugins.getError() << std::endl;
+                return e.getType();
+            }
+        }
+
+        if (profile) {
+            profiler.start(inPath);
+        }
+        std::vector<InstructionResult> binary;
+        {
+            MemTracker::Scope memory(MEM_VALUES);
+            binary = interpreter.interprete(ast, true);
+        }
+        profiler.stop();
         if (error.didError()) {
             return error.getType();
         }
         reader.changeDir(previousPath);
 
-        BinaryWriter binWriter(writer, binary);
-        binWriter.write(outPath);
+        {
+            PhaseTimer::Scope phase(phases, "write", outPath);
+            MemTracker::Scope memory(MEM_WRITER);
+            BinaryWriter binWriter(writer, binary);
+            binWriter.write(outPath);
+        }
 
 
         if (symbolPath != "") {
+            PhaseTimer::Scope phase(phases, "write", symbolPath);
+            MemTracker::Scope memory(MEM_WRITER);
             SymbolsWriter symWriter(writer, interpreter, settings.hexPrefix, settings.binPrefix, settings.delim);
             symWriter.write(symbolPath);
         }
 
+        if (settings.statsPath != "") {
+            PhaseTimer::Scope phase(phases, "write", settings.statsPath);
+            MemTracker::Scope memory(MEM_WRITER);
+            StatsWriter statsWriter(writer, interpreter);
+            statsWriter.write(settings.statsPath);
+        }
+
+        if (settings.profilePath != "") {
+            PhaseTimer::Scope phase(phases, "write", settings.profilePath);
+            MemTracker::Scope memory(MEM_WRITER);
+            ProfileWriter profileWriter(writer, profiler);
+            profileWriter.write(settings.profilePath);
+        }
+
+        if (settings.flameGraphPath != "") {
+            PhaseTimer::Scope phase(phases, "write", settings.flameGraphPath);
+            MemTracker::Scope memory(MEM_WRITER);
+            ProfileWriter profileWriter(writer, profiler, true);
+            profileWriter.write(settings.flameGraphPath);
+        }
+
+        if (settings.timingPath != "") {
+            TimingWriter timingWriter(writer, timer, settings.timingJson);
+            timingWriter.write(settings.timingPath);
+        }
+
+        if (settings.memStatsPath != "") {
+            MemStatsWriter memStatsWriter(writer);
+            memStatsWriter.write(settings.memStatsPath);
+        }
+
+        if (settings.tracePath != "") {
+            TraceWriter traceWriter(writer, timer);
+            traceWriter.write(settings.tracePath);
+        }
+
         return 0;
     }
 
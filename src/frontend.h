@@ -9,6 +9,7 @@
 #include "error.h"
 #include "environment.h"
 #include "colors.h"
+#include "plugin.h"
 
 namespace lasm {
     enum CpuType {
@@ -65,6 +66,20 @@ namespace lasm {
             std::string hexPrefix = "0x";
             std::string binPrefix = "0b";
             std::string delim = ".";
+            // cache statistics are only written if set
+            std::string statsPath = "";
+            // shared objects that define builtins
+            std::vector<std::string> plugins;
+            // phase timings are only written if set
+            std::string timingPath = "";
+            bool timingJson = false;
+            // chrome trace of every phase. only written if set
+            std::string tracePath = "";
+            // allocations by subsystem. only counted with --enable-memtrack
+            std::string memStatsPath = "";
+            // the profiler only runs if one of them is set
+            std::string profilePath = "";
+            std::string flameGraphPath = "";
             inline static FormatOutput defaultFormat;
             FormatOutput &format;
     };
@@ -87,6 +102,9 @@ namespace lasm {
             FileWriter &writer;
             std::ostream &errorOut;
             FrontendSettings &settings;
+
+            // outlives every interpreter so plugin callables stay valid
+            PluginLoader plugins;
     };
 }
 
@@ -23,7 +23,12 @@ namespace lasm {
         public:
             InstructionResult(std::shared_ptr<char[]> data=std::shared_ptr<char[]>(nullptr), unsigned long size=0,
                     unsigned long address=0, std::shared_ptr<Token> name=std::shared_ptr<Token>(nullptr)):
-                data(data), size(size), address(address) {}
+                data(data), size(size), address(address) {
+                if (size) {
+                    LASM_STAT(instructionResults);
+                    LASM_STAT_ADD(instructionBytes, size);
+                }
+            }
 
             std::shared_ptr<char[]> getData() { return data; }
             unsigned long getSize() { return size; }
@@ -4,6 +4,16 @@
 #include <algorithm>
 #include "scanner.h"
 #include "parser.h"
+#include "optimizer.h"
+#include "memtrack.h"
+#include "purity.h"
+#include "tables.h"
+#include "compress.h"
+#include "utility.h"
+#include "bytearray.h"
+#include "list.h"
+#include "dict.h"
+#include "range.h"
 
 namespace lasm {
     Interpreter::Interpreter(BaseError &onError, BaseInstructionSet &is, InterpreterCallback *callback,
@@ -36,42 +46,211 @@ namespace lasm {
         auto setEnvName = LasmObject(CALLABLE_O, std::static_pointer_cast<Callable>(
                     std::shared_ptr<NativeSetEnvName>(new NativeSetEnvName())));
         globals->define("setScopeName", setEnvName);
+
+        // table generators
+        defineNative<NativeSinTable>("sintable");
+        defineNative<NativeCosTable>("costable");
+        defineNative<NativePopcountTable>("popcounttable");
+        defineNative<NativeBitrevTable>("bitrevtable");
+        defineNative<NativeQuarterSquareTable>("qsquaretable");
+        defineNative<NativeRecipTable>("reciptable");
+        defineNative<NativeCrc16Table>("crc16table");
+        defineNative<NativeCrc32Table>("crc32table");
+        defineNative<NativeFixed>("fixed");
+        defineNative<NativeFixMul>("fixmul");
+        defineNative<NativeRange>("range");
+
+        // packed arrays
+        defineNative<NativeByteArray>("bytes", 1);
+        defineNative<NativeByteArray>("array16", 2);
+        defineNative<NativeByteArray>("array32", 4);
+        defineNative<NativeSlice>("slice");
+        defineNative<NativeReadBin>("readbin");
+
+        // lists
+        defineNative<NativePush>("push");
+        defineNative<NativeConcat>("concat");
+
+        // strings
+        defineNative<NativeJoin>("join");
+
+        // dicts
+        defineNative<NativeDict>("dict");
+        defineNative<NativeHas>("has");
+        defineNative<NativeKeys>("keys");
+        defineNative<NativeRemove>("remove");
+
+        // compression
+        defineNative<NativePackRle>("pack_rle");
+        defineNative<NativeUnpackRle>("unpack_rle");
+        defineNative<NativePackLz>("pack_lz");
+        defineNative<NativeUnpackLz>("unpack_lz");
+        defineNative<NativePackDte>("pack_dte");
+
+        for (auto &builtin : builtins) {
+            LasmObject native(CALLABLE_O, builtin.second);
+            globals->define(builtin.first, native);
+        }
+    }
+
+    void Interpreter::defineBuiltin(const std::string &name, std::shared_ptr<Callable> callable) {
+        builtins.push_back(std::make_pair(name, callable));
+        LasmObject native(CALLABLE_O, callable);
+        globals->define(name, native);
     }
 
-    std::vector<InstructionResult> Interpreter::interprete(std::vector<std::shared_ptr<Stmt>> stmts,
+    std::vector<InstructionResult> Interpreter::interprete(const std::vector<std::shared_ptr<Stmt>> &stmts,
             bool abortOnError, int passes) {
         for (int i = 0; i < passes && (!onError.didError() || !abortOnError); i++) {
+            PhaseTimer::Scope phase(timer, "pass " + std::to_string(i + 1));
             execPass(stmts);
         }
         return code;
     }
 
-    void Interpreter::execPass(std::vector<std::shared_ptr<Stmt>> stmts) {
+    void Interpreter::execPass(const std::vector<std::shared_ptr<Stmt>> &stmts) {
         labels = globalLabels;
         environment = globals;
 
-        environment->clear();
-        labelTable.clear();
-        labelTable.push_back(globalLabels);
+        symbols.clear();
+        scopeOrder = 0;
         code.clear();
-        initGlobals();
         address = 0;
+        returning = false;
+        tailCall.clear();
+        functionDepth = 0;
+
+        // later passes start after the prelude of the first pass
+        unsigned long first = 0;
+        if (pass != 0 && prelude.matches(stmts)) {
+            prelude.restore(globals);
+            first = prelude.size();
+        } else {
+            environment->clear();
+            initGlobals();
+            prelude.begin(globals);
+        }
+
+        std::vector<std::string> names;
         try {
-            for (auto stmt : stmts) {
+            for (unsigned long i = first; i < stmts.size(); i++) {
+                auto &stmt = stmts[i];
+
+                names.clear();
+                bool invariant = prelude.isOpen() && pass == 0 && isPassInvariant(stmt.get(), names);
+                if (!invariant) {
+                    prelude.close();
+                }
+
                 execute(stmt);
+                // a return outside of a function only ends the current statement
+                returning = false;
+
+                if (invariant) {
+                    prelude.add(stmt.get(), globals, names);
+                }
             }
         } catch (LasmException &e) {
             onError.onError(e.getType(), e.getToken(), &e);
         }
+        prelude.close();
         pass++;
     }
 
-    void Interpreter::execute(std::shared_ptr<Stmt> stmt) {
+    bool Interpreter::isPassInvariant(Stmt *stmt, std::vector<std::string> &names) {
+        if (!stmt) {
+            return false;
+        }
+
+        PurityAnalyzer analyzer(this);
+        switch (stmt->getType()) {
+            case FUNCTION_STMT:
+                names.push_back(static_cast<FunctionStmt*>(stmt)->name->getLexeme());
+                return true;
+            case LET_STMT: {
+                auto let = static_cast<LetStmt*>(stmt);
+                names.push_back(let->name->getLexeme());
+                return !let->init.get() || analyzer.isInvariant(let->init);
+            }
+            case BSS_STMT: {
+                auto bss = static_cast<BssStmt*>(stmt);
+                if (!analyzer.isInvariant(bss->startAddress)) {
+                    return false;
+                }
+                for (auto &declaration : bss->declarations) {
+                    names.push_back(declaration->name->getLexeme());
+                    if (!analyzer.isInvariant(declaration->init)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    void Interpreter::execute(const std::shared_ptr<Stmt> &stmt) {
         stmt->accept(this);
     }
 
-    LasmObject Interpreter::evaluate(std::shared_ptr<Expr> expr) {
-        return std::any_cast<LasmObject>(expr->accept(this));
+    LasmObject Interpreter::evaluate(const std::shared_ptr<Expr> &expr) {
+        if (recording || !ExpressionCache::isCandidate(expr.get())) {
+            return std::any_cast<LasmObject>(expr->accept(this));
+        }
+
+        auto &entry = expressionCache.get(expr.get());
+        if (entry.disabled) {
+            return std::any_cast<LasmObject>(expr->accept(this));
+        }
+
+        if (entry.valid && isUnchanged(entry)) {
+            expressionCache.onHit();
+            entry.misses = 0;
+            return entry.result;
+        }
+        expressionCache.onMiss();
+
+        // record every variable the expression reads on this function level
+        std::vector<ExpressionDependency> dependencies;
+        recording = &dependencies;
+        recordingCacheable = true;
+        recordingDepth = functionDepth;
+
+        LasmObject result(NIL_O, nullptr);
+        try {
+            result = std::any_cast<LasmObject>(expr->accept(this));
+        } catch (...) {
+            recording = nullptr;
+            throw;
+        }
+        recording = nullptr;
+
+        expressionCache.store(entry, dependencies, result, recordingCacheable);
+        return result;
+    }
+
+    void Interpreter::record(VariableExpr *expr, LasmObject *value) {
+        if (!recording || functionDepth != recordingDepth) {
+            return;
+        }
+
+        // lists and arrays can change without being reassigned
+        if (value && value->isMutable()) {
+            recordingCacheable = false;
+        }
+        recording->push_back(ExpressionDependency(expr, value));
+    }
+
+    bool Interpreter::isUnchanged(ExpressionCache::Entry &entry) {
+        // the dependencies are checked in the order they were read.
+        // if all of them match the evaluation takes the same path again
+        for (auto &dependency : entry.dependencies) {
+            if (!dependency.matches(lookUp(dependency.expr).get())) {
+                return false;
+            }
+        }
+        return true;
     }
 
     std::any Interpreter::visitBinary(BinaryExpr *expr) {
@@ -129,9 +308,13 @@ namespace lasm {
                     return LasmObject(REAL_O, left.toReal() + right.toReal());
                 } else if (left.isString() && right.isString()) {
                     // string cat
-                    return LasmObject(STRING_O, left.toString() + right.toString());
+                    return LasmObject(STRING_O, LasmString::concat(left.toLasmString(), right.toLasmString()));
+                } else if (left.isList() && right.isList()) {
+                    return LasmObject(LIST_O, left.toList()->concat(*right.toList()));
+                } else if (left.isBytes() && right.isBytes()) {
+                    return LasmObject(BYTES_O, left.toBytes()->concat(*right.toBytes()));
                 } else {
-                    throw LasmTypeError(std::vector<ObjectType> {NUMBER_O, REAL_O, STRING_O}, left.getType(), expr->op);
+                    throw LasmTypeError(std::vector<ObjectType> {NUMBER_O, REAL_O, STRING_O, LIST_O, BYTES_O}, left.getType(), expr->op);
                 }
                 break;
 
@@ -252,6 +435,19 @@ namespace lasm {
     }
 
     std::any Interpreter::visitVariable(VariableExpr *expr) {
+        auto value = lookUp(expr);
+        record(expr, value.get());
+        if (!value.get()) {
+            return LasmObject(NIL_O, 0);
+        }
+        return LasmObject(value.get());
+    }
+
+    std::shared_ptr<LasmObject> Interpreter::lookUp(VariableExpr *expr) {
+        if (expr->constantPass == pass) {
+            return expr->constant;
+        }
+
         // label environment. used for n+1th pass
         // only set if it has not already been assigned
         bool wasFirstPass = false;
@@ -260,21 +456,30 @@ namespace lasm {
             expr->setEnv(address, labels);
         }
         try {
-            // TODO can we avoid copy constructor? does it matter?
-            return LasmObject(environment->get(expr->name).get());
+            auto value = environment->get(expr->name);
+
+            auto &name = expr->name->getLexeme();
+            if (globals->isConstant(name) && globals->getValues().find(name)->second == value) {
+                expr->constant = value;
+                expr->constantPass = pass;
+            }
+            return value;
         } catch (LasmUndefinedReference &e) {
             // attempt getting label by name, but only on second+ pass
             if (expr->getEnv(address).get() && !wasFirstPass) {
-                return LasmObject(expr->getEnv(address)->get(expr->name).get());
+                return expr->getEnv(address)->get(expr->name);
             } else if (!wasFirstPass) {
                 throw e; // only re-throw on second+ pass
             }
         }
 
-        return LasmObject(NIL_O, 0);
+        return std::shared_ptr<LasmObject>(nullptr);
     }
 
     std::any Interpreter::visitAssign(AssignExpr *expr) {
+        if (functionDepth == recordingDepth) {
+            recordingCacheable = false;
+        }
         auto value = evaluate(expr->value);
 
         environment->assign(expr->name, value);
@@ -298,79 +503,148 @@ namespace lasm {
     }
 
     std::any Interpreter::visitCall(CallExpr *expr) {
-        auto callee = evaluate(expr->callee);
+        return invoke(expr);
+    }
+
+    LasmObject Interpreter::invoke(CallExpr *expr, bool tailPosition) {
+        // named callees are used in place instead of being copied
+        std::shared_ptr<LasmObject> callee;
+        auto variable = dynamic_cast<VariableExpr*>(expr->callee.get());
+        if (variable) {
+            callee = lookUp(variable);
+            record(variable, callee.get());
+        } else {
+            callee = std::make_shared<LasmObject>(evaluate(expr->callee));
+        }
 
-        std::vector<LasmObject> arguments;
-        for (auto arg : expr->arguments) {
-            arguments.push_back(evaluate(arg));
+        ArgumentFrame arguments(argumentStack, expr->arguments.size());
+        for (unsigned long i = 0; i < expr->arguments.size(); i++) {
+            arguments[i] = evaluate(expr->arguments[i]);
         }
 
-        if (callee.getType() != CALLABLE_O) {
+        if (!callee.get() || callee->getType() != CALLABLE_O) {
             throw LasmNotCallable(expr->paren);
         }
 
-        auto function = callee.toCallable();
+        auto function = callee->toCallable();
+
+        // calls of lasm functions are left to their memo table
+        if (recording && functionDepth == recordingDepth
+                && (!function->isPure(this) || dynamic_cast<LasmFunction*>(function.get()))) {
+            recordingCacheable = false;
+        }
 
-        if (function->getArity() != arguments.size()) {
+        if (expr->arguments.size() < function->getArity() || expr->arguments.size() > function->getMaxArity()) {
             throw LasmArityError(expr->paren);
         }
 
-        return function->call(this, arguments, expr);
+        if (tailPosition && dynamic_cast<LasmFunction*>(function.get())) {
+            tailCall.callee = function;
+            tailCall.expr = expr;
+            tailCall.arguments.assign(arguments.getArguments().begin(), arguments.getArguments().end());
+            tailCall.environment = environment;
+            tailCall.labels = labels;
+            return LasmObject(NIL_O, nullptr);
+        }
+
+        return function->call(this, arguments.getArguments(), expr);
     }
 
     std::any Interpreter::visitList(ListExpr *expr) {
-        auto values = std::make_shared<std::vector<LasmObject>>(std::vector<LasmObject>());
+        std::vector<LasmObject> values;
+        values.reserve(expr->list.size());
 
         // evaluate all array members
         for (auto init : expr->list) {
-            values->push_back(evaluate(init));
+            values.push_back(evaluate(init));
         }
 
-        return LasmObject(LIST_O, values);
+        return LasmObject(LIST_O, std::make_shared<LasmList>(std::move(values)));
     }
 
     std::any Interpreter::visitIndex(IndexExpr *expr) {
         auto value = evaluate(expr->object);
         auto index = evaluate(expr->index);
 
+        // missing keys are nil
+        if (value.isDict()) {
+            if (!LasmDict::isKey(index)) {
+                throw LasmTypeError(std::vector<ObjectType> {NUMBER_O, STRING_O}, index.getType(), expr->token);
+            }
+            auto found = value.toDict()->find(index);
+            return found ? *found : LasmObject(NIL_O, nullptr);
+        }
+
         if (!index.isNumber()) {
             throw LasmTypeError(std::vector<ObjectType> {NUMBER_O}, index.getType(), expr->token);
         }
 
         LasmObject result(NIL_O, nullptr);
         if (value.isString()) {
-            if ((unsigned long)value.toString().length() < (unsigned long)index.toNumber()) {
+            auto str = value.toLasmString();
+            if (index.toNumber() < 0 || (unsigned long)index.toNumber() >= str->length()) {
+                throw LasmException(INDEX_OUT_OF_BOUNDS, expr->token);
+            }
+            return LasmObject(NUMBER_O, (lasmNumber)str->at(index.toNumber()));
+        } else if (value.isRange()) {
+            if ((unsigned long)index.toNumber() >= value.toRange()->size()) {
                 throw LasmException(INDEX_OUT_OF_BOUNDS, expr->token);
             }
-            return LasmObject(NUMBER_O, (lasmNumber)value.toString().at(index.toNumber()));
+            return value.toRange()->at(index.toNumber());
         } else if (value.isList()) {
-            if ((unsigned long)value.toList()->size() < (unsigned long)index.toNumber()) {
+            if ((unsigned long)index.toNumber() >= value.toList()->size()) {
                 throw LasmException(INDEX_OUT_OF_BOUNDS, expr->token);
             }
             return value.toList()->at(index.toNumber());
+        } else if (value.isBytes()) {
+            if (index.toNumber() < 0 || (unsigned long)index.toNumber() >= value.toBytes()->size()) {
+                throw LasmException(INDEX_OUT_OF_BOUNDS, expr->token);
+            }
+            return LasmObject(NUMBER_O, value.toBytes()->get(index.toNumber()));
         } else {
-            throw LasmTypeError(std::vector<ObjectType> {STRING_O, LIST_O}, value.getType(), expr->token);
+            throw LasmTypeError(std::vector<ObjectType> {STRING_O, LIST_O, BYTES_O, DICT_O}, value.getType(), expr->token);
         }
 
         return result;
     }
 
     std::any Interpreter::visitIndexAssign(IndexAssignExpr *expr) {
+        if (functionDepth == recordingDepth) {
+            recordingCacheable = false;
+        }
         auto value = evaluate(expr->value);
         auto index = evaluate(expr->index);
         auto object = evaluate(expr->object);
+
+        if (object.isDict()) {
+            if (!LasmDict::isKey(index)) {
+                throw LasmTypeError(std::vector<ObjectType> {NUMBER_O, STRING_O}, index.getType(), expr->token);
+            }
+            object.toDict()->set(index, value);
+            return value;
+        }
+
         if (!index.isNumber()) {
             throw LasmTypeError(std::vector<ObjectType> {NUMBER_O}, index.getType(), expr->token);
         }
 
         if (object.isList()) {
-            if ((unsigned long)object.toList()->size() < (unsigned long)index.toNumber()) {
+            if ((unsigned long)index.toNumber() >= object.toList()->size()) {
+                throw LasmException(INDEX_OUT_OF_BOUNDS, expr->token);
+            }
+            object.toList()->set(index.toNumber(), value);
+            return value;
+        } else if (object.isBytes()) {
+            if (index.toNumber() < 0 || (unsigned long)index.toNumber() >= object.toBytes()->size()) {
                 throw LasmException(INDEX_OUT_OF_BOUNDS, expr->token);
             }
-            object.toList()->at(index.toNumber()) = value;
+            if (!value.isNumber()) {
+                throw LasmTypeError(std::vector<ObjectType> {NUMBER_O}, value.getType(), expr->token);
+            }
+            object.toBytes()->set(index.toNumber(), value.toNumber());
             return value;
         } else {
-            throw LasmTypeError(std::vector<ObjectType> {STRING_O, LIST_O}, object.getType(), expr->token);
+            throw LasmTypeError(std::vector<ObjectType> {STRING_O, LIST_O, BYTES_O, DICT_O}, object.getType(), expr->token);
         }
 
         return value;
@@ -392,34 +666,73 @@ namespace lasm {
             value = evaluate(stmt->init);
         }
 
-        environment->define(stmt->name->getLexeme(), value);
+        define(stmt->name, value, stmt->constant);
         return std::any();
     }
 
+    void Interpreter::define(const std::shared_ptr<Token> &name, LasmObject &value, bool constant) {
+        assertNotConstant(name);
+        if (environment->isConstant(name->getLexeme())) {
+            throw LasmException(CONST_REDEFINITION, name);
+        }
+
+        if (constant) {
+            environment->defineConstant(name->getLexeme(), value);
+        } else {
+            environment->define(name->getLexeme(), value);
+        }
+    }
+
+    void Interpreter::assertNotConstant(const std::shared_ptr<Token> &name) {
+        if (globals->isConstant(name->getLexeme())) {
+            throw LasmException(CONST_REDEFINITION, name);
+        }
+    }
+
     std::any Interpreter::visitBlock(BlockStmt *stmt) {
-        executeBlock(stmt->statements, std::make_shared<Environment>(Environment(environment)));
+        ScopedEnvironment scope(environmentPool, environment);
+        executeBlock(stmt->statements, scope.get());
         return std::any();
     }
 
-    void Interpreter::executeBlock(std::vector<std::shared_ptr<Stmt>> statements,
-            std::shared_ptr<Environment> environment, std::shared_ptr<Environment> labels) {
-
+    void Interpreter::executeBlock(const std::vector<std::shared_ptr<Stmt>> &statements,
+            const std::shared_ptr<Environment> &environment, std::shared_ptr<Environment> labels) {
         if (!labels.get()) {
-            labels = std::make_shared<Environment>(Environment(this->labels));
+            // the label scope is recycled once it was compacted
+            ScopedEnvironment scope(environmentPool, this->labels);
+            executeScope(statements, environment, scope.get());
+        } else {
+            executeScope(statements, environment, labels);
         }
+    }
 
-        labelTable.push_back(labels);
+    void Interpreter::executeScope(const std::vector<std::shared_ptr<Stmt>> &statements,
+            const std::shared_ptr<Environment> &environment, const std::shared_ptr<Environment> &labels) {
+        labels->setScopeOrder(++scopeOrder);
 
         auto previous = this->environment;
         auto previousLabels = this->labels;
 
         this->environment = environment;
         this->labels = labels;
-        for (auto statement : statements) {
-            execute(statement);
+        try {
+            for (const auto &statement : statements) {
+                execute(statement);
+                if (returning) {
+                    break;
+                }
+            }
+        } catch (...) {
+            this->environment = previous;
+            this->labels = previousLabels;
+            symbols.compact(labels);
+            throw;
         }
         this->environment = previous;
         this->labels = previousLabels;
+
+        // keep only the labels, not the scope itself
+        symbols.compact(labels);
     }
 
     std::any Interpreter::visitIf(IfStmt *stmt) {
@@ -432,18 +745,91 @@ namespace lasm {
     }
 
     std::any Interpreter::visitWhile(WhileStmt *stmt) {
+        CallbackScope scope(callback, stmt);
         auto previousLabels = labels;
         while (evaluate(stmt->condition).isTruthy()) {
+            LASM_STAT(loopIterations);
             execute(stmt->body);
+            if (returning) {
+                break;
+            }
         }
         labels = previousLabels;
         return std::any();
     }
 
+    std::any Interpreter::visitForIn(ForInStmt *stmt) {
+        auto iterable = evaluate(stmt->iterable);
+        if (iterable.isDict()) {
+            iterable = LasmObject(LIST_O, iterable.toDict()->keys());
+        } else if (!iterable.isList() && !iterable.isBytes() && !iterable.isString()) {
+            throw LasmTypeError(std::vector<ObjectType> {LIST_O, RANGE_O, BYTES_O, STRING_O, DICT_O},
+                    iterable.getType(), stmt->name);
+        }
+        assertNotConstant(stmt->name);
+
+        CallbackScope profile(callback, stmt);
+
+        // the loop variable is defined once and overwritten in place
+        ScopedEnvironment scope(environmentPool, environment);
+        LasmObject nil(NIL_O, nullptr);
+        scope->define(stmt->name->getLexeme(), nil);
+        auto slot = scope->get(stmt->name);
+
+        std::shared_ptr<LasmRange> range;
+        std::shared_ptr<LasmList> list;
+        std::shared_ptr<ByteArray> array;
+        std::shared_ptr<LasmString> str;
+        unsigned long length = 0;
+        if (iterable.isRange()) {
+            range = iterable.toRange();
+            length = range->size();
+        } else if (iterable.isList()) {
+            list = iterable.toList();
+            length = list->size();
+        } else if (iterable.isBytes()) {
+            array = iterable.toBytes();
+            length = array->size();
+        } else {
+            str = iterable.toLasmString();
+            length = str->length();
+        }
+
+        auto previous = environment;
+        auto previousLabels = labels;
+        environment = scope.get();
+        try {
+            for (unsigned long i = 0; i < length; i++) {
+                if (range.get()) {
+                    *slot = range->at(i);
+                } else if (list.get()) {
+                    *slot = list->at(i);
+                } else if (array.get()) {
+                    *slot = LasmObject(NUMBER_O, array->get(i));
+                } else {
+                    *slot = LasmObject(NUMBER_O, (lasmNumber)str->at(i));
+                }
+
+                LASM_STAT(loopIterations);
+                execute(stmt->body);
+                if (returning) {
+                    break;
+                }
+            }
+        } catch (...) {
+            environment = previous;
+            labels = previousLabels;
+            throw;
+        }
+        environment = previous;
+        labels = previousLabels;
+        return std::any();
+    }
+
     std::any Interpreter::visitFunction(FunctionStmt *stmt) {
         auto fn = std::make_shared<LasmFunction>(LasmFunction(stmt));
         LasmObject obj(CALLABLE_O, std::static_pointer_cast<Callable>(fn));
-        environment->define(stmt->name->getLexeme(), obj);
+        define(stmt->name, obj);
         return std::any();
     }
 
@@ -451,10 +837,28 @@ namespace lasm {
         LasmObject value(NIL_O, nullptr);
 
         if (stmt->value.get()) {
-            value = evaluate(stmt->value);
+            // a call in tail position is run by the enclosing function
+            // after this body was left. the native stack does not grow
+            auto call = dynamic_cast<CallExpr*>(stmt->value.get());
+            if (call && functionDepth > 0) {
+                value = invoke(call, true);
+            } else {
+                value = evaluate(stmt->value);
+            }
+        }
+        returnValue = value;
+        returning = true;
+        return std::any();
+    }
+
+    LasmObject Interpreter::takeReturnValue() {
+        if (!returning) {
+            return LasmObject(NIL_O, nullptr);
         }
-        // TODO this is kinda ugly but functional
-        throw Return(value);
+        returning = false;
+        LasmObject value = returnValue;
+        returnValue = LasmObject(NIL_O, nullptr);
+        return value;
     }
 
     std::any Interpreter::visitInstruction(InstructionStmt *stmt) {
@@ -462,6 +866,7 @@ namespace lasm {
         // and set unresolved flag along with the expression.
         // after assembly ends do a second pass and attempt to
         // resolve again
+        MemTracker::Scope memory(MEM_CODE);
         onInstructionResult(instructions.generate(this, stmt->info, stmt));
         return std::any();
     }
@@ -490,6 +895,7 @@ namespace lasm {
         }
 
         // make byte array with fill value as instruction result
+        MemTracker::Scope memory(MEM_CODE);
         std::shared_ptr<char[]> data(new char[size]);
         memset(data.get(), fillValue.toNumber(), size);
         onInstructionResult(InstructionResult(data, size, getAddress()-size, stmt->token));
@@ -511,6 +917,7 @@ namespace lasm {
 
         // make data of address-fillTo
         unsigned long size = (unsigned long)fillTo.toNumber() - address;
+        MemTracker::Scope memory(MEM_CODE);
         std::shared_ptr<char[]> data(new char[size]);
         memset(data.get(), fillValue.toNumber(), size);
         address += size;
@@ -536,98 +943,120 @@ namespace lasm {
 
     // TODO test endianess
     std::any Interpreter::visitDefineByte(DefineByteStmt *stmt) {
-        // loop all exprs. each entry gets a node as code
-        for (auto value : stmt->values) {
-            auto evaluated = evaluate(value);
-            std::shared_ptr<char[]> data;
-
-            if (evaluated.isString()) {
-                data = std::shared_ptr<char[]>(new char[evaluated.toString().length()+1]);
-                // for string we ignore endianess anyway
-                strncpy(data.get(), evaluated.toString().c_str(), evaluated.toString().length()+1);
-                onInstructionResult(InstructionResult(data, evaluated.toString().length()+1, getAddress(), stmt->token));
-                address += evaluated.toString().length()+1;
-            } else if (evaluated.isScalar() || evaluated.isBool()) {
-                data = std::shared_ptr<char[]>(new char[stmt->size]);
-                switch (stmt->size) {
-                    case 1: {
-                                char value = 0;
-                                if (evaluated.isBool()) {
-                                    value = evaluated.toBool();
-                                } else if (evaluated.isNumber()) {
-                                    value = evaluated.toNumber();
-                                } else {
-                                    throw LasmException(VALUE_OUT_OF_RANGE, stmt->token);
-                                }
-                                memcpy(data.get(), &value, stmt->size);
-                                break;
-                            }
-                    case 2: {
-                                short value = 0;
-                                if (evaluated.isBool()) {
-                                    value = evaluated.toBool();
-                                } else if (evaluated.isNumber()) {
-                                    value = evaluated.toNumber();
-                                } else {
-                                    throw LasmException(VALUE_OUT_OF_RANGE, stmt->token);
-                                }
-                                memcpy(data.get(), &value, stmt->size);
-                                break;
-                            }
-                    case 4: {
-                                int value = 0;
-                                if (evaluated.isBool()) {
-                                    value = evaluated.toBool();
-                                } else if (evaluated.isNumber()) {
-                                    value = evaluated.toNumber();
-                                } else if (evaluated.isReal()) {
-                                    float evalFloat = evaluated.toReal();
-                                    memcpy(&value, &evalFloat, stmt->size);
-                                } else {
-                                    throw LasmException(VALUE_OUT_OF_RANGE, stmt->token);
-                                }
-                                memcpy(data.get(), &value, stmt->size);
-                                break;
-                            }
-                    case 8: {
-                                long value = 0;
-                                if (evaluated.isBool()) {
-                                    value = evaluated.toBool();
-                                } else if (evaluated.isNumber()) {
-                                    value = evaluated.toNumber();
-                                } else if (evaluated.isReal()) {
-                                    double evalFloat = evaluated.toReal();
-                                    memcpy(&value, &evalFloat, stmt->size);
-                                } else {
-                                    throw LasmException(VALUE_OUT_OF_RANGE, stmt->token);
-                                }
-                                memcpy(data.get(), &value, stmt->size);
-                                break;
-                            }
-                    default:
-                        throw LasmException(VALUE_OUT_OF_RANGE, stmt->token);
-                }
-
-                // is the required endianess the same as the native endianess?
-                // TODO test this! maybe on a powerpc machine?
-                if (stmt->endianess != getNativeByteOrder()) {
-                    // swap time!
-                    std::shared_ptr<char[]> swapped(new char[stmt->size]);
-                    std::reverse_copy(data.get(), data.get()+stmt->size, swapped.get());
-                    data = swapped;
-                }
+        if (stmt->packed.get()) {
+            onInstructionResult(InstructionResult(stmt->packed, stmt->packedSize, getAddress(), stmt->token));
+            address += stmt->packedSize;
+            return std::any();
+        }
 
-                onInstructionResult(InstructionResult(data, stmt->size, getAddress(), stmt->token));
-                address += stmt->size;
-            } else {
-                throw LasmTypeError(std::vector<ObjectType> {NUMBER_O, REAL_O, BOOLEAN_O, STRING_O},
-                        evaluated.getType(), stmt->token);
+        // values are collected into one block.
+        // code emitted while evaluating a value flushes the bytes before it
+        auto enclosing = defineBuffer;
+        flushDefineBuffer();
+        DefineBuffer buffer(stmt);
+        defineBuffer = &buffer;
+        try {
+            for (auto value : stmt->values) {
+                auto evaluated = evaluate(value);
+                defineValue(stmt, evaluated);
             }
+            flushDefineBuffer();
+        } catch (...) {
+            defineBuffer = enclosing;
+            throw;
         }
+        defineBuffer = enclosing;
 
         return std::any();
     }
 
+    char* Interpreter::reserveDefine(unsigned long size) {
+        MemTracker::Scope memory(MEM_CODE);
+        auto &data = defineBuffer->data;
+        if (!data.empty() && defineBuffer->address + data.size() != getAddress()) {
+            // the address was moved while evaluating a value
+            flushDefineBuffer();
+        }
+        if (data.empty()) {
+            defineBuffer->address = getAddress();
+        }
+
+        auto offset = data.size();
+        data.resize(offset + size);
+        address += size;
+        return data.data() + offset;
+    }
+
+    void Interpreter::flushDefineBuffer() {
+        if (!defineBuffer || defineBuffer->data.empty()) {
+            return;
+        }
+
+        auto size = defineBuffer->data.size();
+        MemTracker::Scope memory(MEM_CODE);
+        std::shared_ptr<char[]> data(new char[size]);
+        memcpy(data.get(), defineBuffer->data.data(), size);
+        defineBuffer->data.clear();
+        onInstructionResult(InstructionResult(data, size, defineBuffer->address, defineBuffer->stmt->token));
+    }
+
+    void Interpreter::defineValue(DefineByteStmt *stmt, LasmObject &evaluated) {
+        if (evaluated.isRange()) {
+            auto range = evaluated.toRange();
+            for (unsigned long i = 0; i < range->size(); i++) {
+                auto element = range->at(i);
+                defineValue(stmt, element);
+            }
+            return;
+        } else if (evaluated.isList()) {
+            for (auto &element : *evaluated.toList()) {
+                defineValue(stmt, element);
+            }
+            return;
+        }
+
+        if (stmt->size != 1 && stmt->size != 2 && stmt->size != 4 && stmt->size != 8) {
+            throw LasmException(VALUE_OUT_OF_RANGE, stmt->token);
+        }
+
+        if (evaluated.isBytes()) {
+            // packed arrays are copied as one block
+            auto array = evaluated.toBytes();
+            unsigned long size = array->size() * stmt->size;
+            if (size == 0) {
+                return;
+            }
+            array->encode(reserveDefine(size), stmt->size, stmt->endianess);
+        } else if (evaluated.isString()) {
+            // for string we ignore endianess anyway
+            auto &str = evaluated.toString();
+            memcpy(reserveDefine(str.length()+1), str.c_str(), str.length()+1);
+        } else if (evaluated.isBool() || evaluated.isNumber()) {
+            long value = evaluated.isBool() ? evaluated.toBool() : evaluated.toNumber();
+            encodeNumber(reserveDefine(stmt->size), value, stmt->size, stmt->endianess);
+        } else if (evaluated.isReal()) {
+            char data[sizeof(double)];
+            if (stmt->size == 4) {
+                float value = evaluated.toReal();
+                memcpy(data, &value, stmt->size);
+            } else if (stmt->size == 8) {
+                double value = evaluated.toReal();
+                memcpy(data, &value, stmt->size);
+            } else {
+                throw LasmException(VALUE_OUT_OF_RANGE, stmt->token);
+            }
+
+            // is the required endianess the same as the native endianess?
+            if (stmt->endianess != getNativeByteOrder()) {
+                std::reverse(data, data+stmt->size);
+            }
+            memcpy(reserveDefine(stmt->size), data, stmt->size);
+        } else {
+            throw LasmTypeError(std::vector<ObjectType> {NUMBER_O, REAL_O, BOOLEAN_O, STRING_O, LIST_O, BYTES_O},
+                    evaluated.getType(), stmt->token);
+        }
+    }
+
     std::any Interpreter::visitBss(BssStmt *stmt) {
         auto startAddress = evaluate(stmt->startAddress);
         if (!startAddress.isNumber()) {
@@ -641,7 +1070,7 @@ namespace lasm {
                 throw LasmTypeError(std::vector<ObjectType> {NUMBER_O}, value.getType(), declaration->name);
             }
             // add start address to it
-            environment->define(declaration->name->getLexeme(), startAddress);
+            define(declaration->name, startAddress);
             startAddress = LasmObject(NUMBER_O, value.toNumber() + startAddress.toNumber());
         }
 
@@ -666,6 +1095,7 @@ namespace lasm {
                 throw LasmTypeError(std::vector<ObjectType> {STRING_O}, path.getType(), stmt->token);
             }
 
+            MemTracker::Scope memory(MEM_CODE);
             auto stream = reader->openFile(path.toString());
             unsigned long size = 0;
             auto data = reader->readFullFile(stream, &size);
@@ -697,29 +1127,57 @@ namespace lasm {
             auto previousPath = reader->getDir();
             reader->changeDir(path.toString(), true);
 
-            auto stream = reader->openFile(path.toString());
-            auto source = std::string(reader->readFullFile(stream).get());
-            reader->closeFile(stream);
+            std::string source;
+            {
+                PhaseTimer::Scope phase(timer, "read", path.toString());
+                MemTracker::Scope memory(MEM_SCANNER);
+                auto stream = reader->openFile(path.toString());
+                source = std::string(reader->readFullFile(stream).get());
+                reader->closeFile(stream);
+            }
 
-            Scanner scanner(onError, instructions, source, path.toString());
-            auto tokens = scanner.scanTokens();
+            std::vector<std::shared_ptr<Token>> tokens;
+            {
+                PhaseTimer::Scope phase(timer, "scan", path.toString());
+                MemTracker::Scope memory(MEM_SCANNER);
+                Scanner scanner(onError, instructions, source, path.toString());
+                tokens = scanner.scanTokens();
+            }
 
             if (onError.didError()) {
                 return std::any();
             }
-            Parser parser(onError, tokens, instructions);
-            auto ast = parser.parse();
+            std::vector<std::shared_ptr<Stmt>> ast;
+            {
+                PhaseTimer::Scope phase(timer, "parse", path.toString());
+                MemTracker::Scope memory(MEM_PARSER);
+                Parser parser(onError, tokens, instructions);
+                ast = parser.parse();
+            }
 
             if (onError.didError()) {
                 return std::any();
             }
+            {
+                PhaseTimer::Scope phase(timer, "optimize", path.toString());
+                MemTracker::Scope memory(MEM_PARSER);
+                // constants of an include in the global scope are global constants
+                Optimizer optimizer(onError, instructions, environment == globals);
+                optimizer.optimize(ast);
+            }
             stmt->stmts = ast;
+            stmt->path = path.toString();
 
             reader->changeDir(previousPath);
         }
+        PhaseTimer::Scope phase(timer, "execute", stmt->path);
+        CallbackScope scope(callback, stmt);
         try {
-            for (auto stmt : stmt->stmts) {
+            for (const auto &stmt : stmt->stmts) {
                 execute(stmt);
+                if (returning) {
+                    break;
+                }
             }
         } catch (LasmException &e) {
             onError.onError(e.getType(), e.getToken(), &e);
@@ -729,19 +1187,11 @@ namespace lasm {
     }
 
     void Interpreter::onInstructionResult(InstructionResult result) {
+        // bytes of an enclosing db statement come first
+        flushDefineBuffer();
         if (pass != 0) {
+            MemTracker::Scope memory(MEM_CODE);
             code.push_back(result);
         }
     }
-
-    Endianess Interpreter::getNativeByteOrder() {
-        // check endianess
-        const unsigned int x = 0x12345678;
-        if (*((char*)&x) == 0x78) {
-            // little endian
-            return LITTLE;
-        }
-        // big endian
-        return BIG;
-    }
 }
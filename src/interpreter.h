@@ -14,6 +14,11 @@
 #include "callable.h"
 #include "instruction.h"
 #include "filereader.h"
+#include "symboltable.h"
+#include "callframe.h"
+#include "prelude.h"
+#include "exprcache.h"
+#include "phasetimer.h"
 
 namespace lasm {
     class InterpreterCallback {
@@ -21,6 +26,36 @@ namespace lasm {
             ~InterpreterCallback() {}
 
             virtual void onStatementExecuted(LasmObject *object) {}
+
+            /**
+             * Called when a function body, a loop or an include starts and ends executing.
+             * stmt is a FunctionStmt, WhileStmt, ForInStmt or IncludeStmt.
+             * Every onEnter has an onExit, even if an error is thrown
+             */
+            virtual void onEnter(Stmt *stmt) {}
+            virtual void onExit(Stmt *stmt) {}
+    };
+
+    /**
+     * Reports a function, loop or include to the callback until the scope is left
+     */
+    class CallbackScope {
+        public:
+            CallbackScope(InterpreterCallback *callback, Stmt *stmt):
+                callback(callback), stmt(stmt) {
+                if (callback) {
+                    callback->onEnter(stmt);
+                }
+            }
+
+            ~CallbackScope() {
+                if (callback) {
+                    callback->onExit(stmt);
+                }
+            }
+        private:
+            InterpreterCallback *callback;
+            Stmt *stmt;
     };
 
     class Interpreter: public ExprVisitor, public StmtVisitor {
@@ -30,6 +65,11 @@ namespace lasm {
 
             void initGlobals();
 
+            /**
+             * Defines a global callable that is defined again in every pass
+             */
+            void defineBuiltin(const std::string &name, std::shared_ptr<Callable> callable);
+
             // TODO first pass:
             // resolve labels by adding them to a speical environment
             // each variable that was not resolvable the first time around gets a pointer to said environment
@@ -38,14 +78,31 @@ namespace lasm {
             // variable names shadow labels
             // second pass:
             // now all variables should be resolved
-            std::vector<InstructionResult> interprete(std::vector<std::shared_ptr<Stmt>> stmts, bool abortOnError=false,
-                    int passes=2);
+            std::vector<InstructionResult> interprete(const std::vector<std::shared_ptr<Stmt>> &stmts,
+                    bool abortOnError=false, int passes=2);
+
+            void execPass(const std::vector<std::shared_ptr<Stmt>> &stmts);
 
-            void execPass(std::vector<std::shared_ptr<Stmt>> stmts);
+            void execute(const std::shared_ptr<Stmt> &stmt);
 
-            void execute(std::shared_ptr<Stmt> stmt);
+            LasmObject evaluate(const std::shared_ptr<Expr> &expr);
 
-            LasmObject evaluate(std::shared_ptr<Expr> expr);
+            /**
+             * Resolves a variable without copying its value.
+             * Returns nullptr for names that are not yet known in the first pass
+             */
+            std::shared_ptr<LasmObject> lookUp(VariableExpr *expr);
+
+            /**
+             * Binds name in the current environment.
+             * Constants can not be redefined, global constants can not be shadowed either
+             */
+            void define(const std::shared_ptr<Token> &name, LasmObject &value, bool constant=false);
+
+            /**
+             * Throws if name would shadow a global constant
+             */
+            void assertNotConstant(const std::shared_ptr<Token> &name);
 
             std::any visitBinary(BinaryExpr *expr);
             std::any visitUnary(UnaryExpr *expr);
@@ -64,6 +121,7 @@ namespace lasm {
             std::any visitBlock(BlockStmt *stmt);
             std::any visitIf(IfStmt *stmt);
             std::any visitWhile(WhileStmt *stmt);
+            std::any visitForIn(ForInStmt *stmt);
             std::any visitFunction(FunctionStmt *stmt);
             std::any visitReturn(ReturnStmt *stmt);
             std::any visitInstruction(InstructionStmt *stmt);
@@ -77,9 +135,32 @@ namespace lasm {
             std::any visitIncbin(IncbinStmt *stmt);
             std::any visitInclude(IncludeStmt *stmt);
 
-            void executeBlock(std::vector<std::shared_ptr<Stmt>> statements, std::shared_ptr<Environment> environment,
+            void executeBlock(const std::vector<std::shared_ptr<Stmt>> &statements,
+                    const std::shared_ptr<Environment> &environment,
                     std::shared_ptr<Environment> labels=std::shared_ptr<Environment>(nullptr));
 
+            /**
+             * Value of the last return statement. Clears the pending return
+             */
+            LasmObject takeReturnValue();
+
+            /**
+             * Calls the callee of expr.
+             * In tail position a call to a lasm function is only prepared
+             * and left to the running function
+             */
+            LasmObject invoke(CallExpr *expr, bool tailPosition=false);
+
+            void onMemoHit() { memoHits++; }
+            void onMemoMiss() { memoMisses++; }
+            unsigned long getMemoHits() { return memoHits; }
+            unsigned long getMemoMisses() { return memoMisses; }
+
+            ExpressionCache& getExpressionCache() { return expressionCache; }
+
+            void enterFunction() { functionDepth++; }
+            void leaveFunction() { functionDepth--; }
+
 
             unsigned long getAddress() { return address; }
             void setAddress(unsigned long newAddress) { address = newAddress; }
@@ -89,13 +170,71 @@ namespace lasm {
 
             std::shared_ptr<Environment> getEnv() { return environment; }
             std::shared_ptr<Environment> getLabels() { return labels; }
-            std::vector<std::shared_ptr<Environment>>& getLabelTable() { return labelTable; }
+            std::shared_ptr<Environment> getGlobalLabels() { return globalLabels; }
+            SymbolTable& getSymbolTable() { return symbols; }
             std::shared_ptr<Environment> getGlobals() { return globals; }
 
             BaseInstructionSet& getInstructions() { return instructions; }
+            FileReader* getReader() { return reader; }
+
+            Prelude& getPrelude() { return prelude; }
+
+            EnvironmentPool& getEnvironmentPool() { return environmentPool; }
+            ArgumentStack& getArgumentStack() { return argumentStack; }
+            TailCall& getTailCall() { return tailCall; }
+
+            /**
+             * Times passes and includes. nullptr disables timing
+             */
+            void setTimer(PhaseTimer *timer) { this->timer = timer; }
+
+            InterpreterCallback* getCallback() { return callback; }
         private:
             void onInstructionResult(InstructionResult result);
 
+            // builtins defined from outside, for example by plugins
+            std::vector<std::pair<std::string, std::shared_ptr<Callable>>> builtins;
+
+            template<typename T, typename... Args>
+            void defineNative(const std::string &name, Args... args) {
+                auto native = LasmObject(CALLABLE_O, std::static_pointer_cast<Callable>(std::make_shared<T>(args...)));
+                globals->define(name, native);
+            }
+
+            /**
+             * Appends one value of a db statement to defineBuffer. Lists are flattened
+             */
+            void defineValue(DefineByteStmt *stmt, LasmObject &evaluated);
+
+            /**
+             * Space for size bytes at the end of defineBuffer. Advances the address
+             */
+            char* reserveDefine(unsigned long size);
+
+            /**
+             * Emits the bytes collected in defineBuffer as one result
+             */
+            void flushDefineBuffer();
+
+            /**
+             * True if stmt only defines globals that are the same in every pass.
+             * names are the globals it defines
+             */
+            bool isPassInvariant(Stmt *stmt, std::vector<std::string> &names);
+
+            /**
+             * Adds a variable read to the evaluation that is being recorded
+             */
+            void record(VariableExpr *expr, LasmObject *value);
+
+            /**
+             * True if no dependency of entry changed since it was stored
+             */
+            bool isUnchanged(ExpressionCache::Entry &entry);
+
+            void executeScope(const std::vector<std::shared_ptr<Stmt>> &statements,
+                    const std::shared_ptr<Environment> &environment, const std::shared_ptr<Environment> &labels);
+
             BaseError &onError;
             BaseInstructionSet &instructions;
             InterpreterCallback *callback;
@@ -108,11 +247,46 @@ namespace lasm {
             std::shared_ptr<Environment> globalLabels;
             std::shared_ptr<Environment> labels;
 
-            // flat list of all labels that were generated during assembly.
+            // all labels that were generated during assembly outside of the global scope.
             // used for label list file
-            std::vector<std::shared_ptr<Environment>> labelTable;
+            SymbolTable symbols;
+            unsigned long scopeOrder = 0;
+
+            // statements that are only executed in the first pass
+            Prelude prelude;
+
+            // call frames. environments and argument slots are reused between calls
+            EnvironmentPool environmentPool;
+            ArgumentStack argumentStack;
+            TailCall tailCall;
+            unsigned long functionDepth = 0;
+
+            // calls of pure functions that were answered by the memo table
+            unsigned long memoHits = 0;
+            unsigned long memoMisses = 0;
+
+            // values of expressions by the variables they read.
+            // only one root expression is recorded at a time
+            ExpressionCache expressionCache;
+            std::vector<ExpressionDependency> *recording = nullptr;
+            bool recordingCacheable = true;
+            unsigned long recordingDepth = 0;
+
+            // set by a return statement until the enclosing function picks up the value
+            bool returning = false;
+            LasmObject returnValue = LasmObject(NIL_O, nullptr);
+
+            // bytes of the db statement that is being executed
+            class DefineBuffer {
+                public:
+                    DefineBuffer(DefineByteStmt *stmt):
+                        stmt(stmt) {}
 
-            Endianess getNativeByteOrder();
+                    DefineByteStmt *stmt;
+                    unsigned long address = 0;
+                    std::vector<char> data;
+            };
+            DefineBuffer *defineBuffer = nullptr;
 
             unsigned long address = 0;
             unsigned short pass = 0;
@@ -120,6 +294,7 @@ namespace lasm {
             std::vector<InstructionResult> code;
 
             FileReader *reader;
+            PhaseTimer *timer = nullptr;
     };
 }
 
@@ -0,0 +1,148 @@
+#include "lasmstring.h"
+#include <vector>
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+
+// shorter concatenations and slices are copied right away
+#define ROPE_MIN_LENGTH 256
+
+namespace lasm {
+    typedef std::unordered_map<std::string_view, std::weak_ptr<LasmString>> InternTable;
+
+    static InternTable& internTable() {
+        // never destroyed. strings may still be released during static destruction
+        static InternTable *table = new InternTable();
+        return *table;
+    }
+
+    LasmString::~LasmString() {
+        if (interned) {
+            auto it = internTable().find(value);
+            if (it != internTable().end() && it->first.data() == value.data()) {
+                internTable().erase(it);
+            }
+        }
+
+        // release deep ropes without recursing through every node
+        std::vector<std::shared_ptr<LasmString>> pending;
+        pending.push_back(std::move(left));
+        pending.push_back(std::move(right));
+        while (!pending.empty()) {
+            auto node = std::move(pending.back());
+            pending.pop_back();
+            if (node.get() && node.use_count() == 1) {
+                pending.push_back(std::move(node->left));
+                pending.push_back(std::move(node->right));
+            }
+        }
+    }
+
+    std::shared_ptr<LasmString> LasmString::make(const std::string &value) {
+        auto &table = internTable();
+        auto it = table.find(value);
+        if (it != table.end()) {
+            auto existing = it->second.lock();
+            if (existing.get()) {
+                return existing;
+            }
+            table.erase(it);
+        }
+
+        auto node = std::shared_ptr<LasmString>(new LasmString(value.length()));
+        node->value = value;
+        node->interned = true;
+        table.emplace(std::string_view(node->value), node);
+        return node;
+    }
+
+    std::shared_ptr<LasmString> LasmString::concat(const std::shared_ptr<LasmString> &left,
+            const std::shared_ptr<LasmString> &right) {
+        if (left->size == 0) {
+            return right;
+        } else if (right->size == 0) {
+            return left;
+        }
+
+        if (left->size + right->size < ROPE_MIN_LENGTH) {
+            return make(left->get() + right->get());
+        }
+
+        auto node = std::shared_ptr<LasmString>(new LasmString(left->size + right->size));
+        node->left = left->flat.get() ? left->flat : left;
+        node->right = right->flat.get() ? right->flat : right;
+        return node;
+    }
+
+    std::shared_ptr<LasmString> LasmString::slice(const std::shared_ptr<LasmString> &value,
+            size_t start, size_t end) {
+        end = std::min(end, value->size);
+        start = std::min(start, end);
+        if (start == 0 && end == value->size) {
+            return value;
+        }
+
+        if (end - start < ROPE_MIN_LENGTH) {
+            return make(value->get().substr(start, end - start));
+        }
+
+        auto node = std::shared_ptr<LasmString>(new LasmString(end - start));
+        if (value->source.get()) {
+            node->source = value->source;
+            node->start = value->start + start;
+        } else {
+            value->canonical();
+            node->source = value->interned ? value : value->flat;
+            node->start = start;
+        }
+        return node;
+    }
+
+    char LasmString::at(size_t index) {
+        if (source.get()) {
+            return source->value[start + index];
+        }
+        return get()[index];
+    }
+
+    LasmString* LasmString::canonical() {
+        if (interned) {
+            return this;
+        }
+        if (!flat.get()) {
+            flatten();
+        }
+        return flat.get();
+    }
+
+    void LasmString::flatten() {
+        std::string result;
+        result.reserve(size);
+
+        std::vector<LasmString*> stack;
+        stack.push_back(this);
+        while (!stack.empty()) {
+            auto node = stack.back();
+            stack.pop_back();
+            if (node->interned) {
+                result += node->value;
+            } else if (node->flat.get()) {
+                result += node->flat->value;
+            } else if (node->source.get()) {
+                result.append(node->source->value, node->start, node->size);
+            } else {
+                stack.push_back(node->right.get());
+                stack.push_back(node->left.get());
+            }
+        }
+
+        flat = make(result);
+        left.reset();
+        right.reset();
+        source.reset();
+    }
+
+    unsigned long LasmString::internedCount() {
+        return internTable().size();
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef __LASMSTRING_H__
+#define __LASMSTRING_H__
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace lasm {
+    /**
+     * Immutable value of a string object.
+     * Strings are interned, so two equal strings share one canonical node
+     * and compare by pointer. Long concatenations and slices are kept as a rope
+     * or a view until their contents are needed
+     */
+    class LasmString {
+        public:
+            ~LasmString();
+
+            /**
+             * The canonical node of value
+             */
+            static std::shared_ptr<LasmString> make(const std::string &value);
+
+            static std::shared_ptr<LasmString> concat(const std::shared_ptr<LasmString> &left,
+                    const std::shared_ptr<LasmString> &right);
+
+            /**
+             * Characters from start up to but excluding end.
+             * Long slices share the characters of value
+             */
+            static std::shared_ptr<LasmString> slice(const std::shared_ptr<LasmString> &value,
+                    size_t start, size_t end);
+
+            const std::string& get() { return canonical()->value; }
+            size_t length() { return size; }
+
+            /**
+             * Character at index. Does not flatten slices
+             */
+            char at(size_t index);
+
+            /**
+             * Interned node with the same contents. Flattens a rope once
+             */
+            LasmString* canonical();
+
+            /**
+             * Number of distinct strings that are currently interned
+             */
+            static unsigned long internedCount();
+        private:
+            LasmString(size_t size):
+                size(size) {}
+
+            void flatten();
+
+            // interned contents. empty for ropes
+            std::string value;
+            bool interned = false;
+
+            // rope children until the rope is flattened
+            std::shared_ptr<LasmString> left;
+            std::shared_ptr<LasmString> right;
+            // canonical node of a flattened rope or slice
+            std::shared_ptr<LasmString> flat;
+
+            // interned node a slice points into
+            std::shared_ptr<LasmString> source;
+            size_t start = 0;
+
+            size_t size = 0;
+    };
+}
+
+#endif
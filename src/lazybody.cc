@@ -0,0 +1,27 @@
+#include "lazybody.h"
+#include "parser.h"
+#include "optimizer.h"
+#include "memtrack.h"
+
+namespace lasm {
+    std::vector<std::shared_ptr<Stmt>> LazyBody::parse() {
+        MemTracker::Scope memory(MEM_PARSER);
+        Parser parser(onError, tokens, instructions);
+        auto body = parser.parse();
+
+        // a statement that failed to parse is nullptr
+        std::vector<std::shared_ptr<Stmt>> parsed;
+        for (auto &stmt : body) {
+            if (stmt.get()) {
+                parsed.push_back(stmt);
+            }
+        }
+
+        Optimizer optimizer(onError, instructions, false);
+        if (constants.get()) {
+            optimizer.inlineConstants(*constants);
+        }
+        optimizer.optimize(parsed);
+        return parsed;
+    }
+}
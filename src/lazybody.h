@@ -0,0 +1,45 @@
+#ifndef __LAZYBODY_H__
+#define __LAZYBODY_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <map>
+#include <string>
+#include "token.h"
+#include "object.h"
+
+namespace lasm {
+    class Stmt;
+    class BaseError;
+    class BaseInstructionSet;
+
+    typedef std::map<std::string, LasmObject> ConstantTable;
+
+    /**
+     * Tokens of a function body that is parsed on its first call.
+     * Functions of large libraries that are never called are never parsed
+     */
+    class LazyBody {
+        public:
+            LazyBody(BaseError &onError, BaseInstructionSet &instructions):
+                onError(onError), instructions(instructions) {}
+
+            /**
+             * Parses and optimizes the body. Parser errors are reported to onError
+             * and leave the statements that were parsed without an error
+             */
+            std::vector<std::shared_ptr<Stmt>> parse();
+
+            // body without its braces, ends with an EOF token
+            std::vector<std::shared_ptr<Token>> tokens;
+
+            // global constants known to the optimizer at the declaration
+            std::shared_ptr<const ConstantTable> constants;
+        private:
+            BaseError &onError;
+            BaseInstructionSet &instructions;
+    };
+}
+
+#endif
@@ -0,0 +1,51 @@
+#include "list.h"
+#include <algorithm>
+
+namespace lasm {
+    void LasmList::set(unsigned long index, const LasmObject &value) {
+        if (storage.use_count() > 1) {
+            auto own = copy(length);
+            storage = own->storage;
+            offset = 0;
+        }
+        (*storage)[offset + index] = value;
+    }
+
+    std::shared_ptr<LasmList> LasmList::push(const LasmObject &value) {
+        if (!canGrow()) {
+            auto result = copy(length * 2 + 1);
+            result->storage->push_back(value);
+            result->length++;
+            return result;
+        }
+
+        storage->push_back(value);
+        return std::shared_ptr<LasmList>(new LasmList(storage, offset, length + 1));
+    }
+
+    std::shared_ptr<LasmList> LasmList::concat(LasmList &other) {
+        // inserting a buffer into itself is not allowed
+        if (!canGrow() || other.storage == storage) {
+            auto result = copy((length + other.length) * 2);
+            result->storage->insert(result->storage->end(), other.begin(), other.end());
+            result->length += other.length;
+            return result;
+        }
+
+        storage->insert(storage->end(), other.begin(), other.end());
+        return std::shared_ptr<LasmList>(new LasmList(storage, offset, length + other.length));
+    }
+
+    std::shared_ptr<LasmList> LasmList::slice(unsigned long start, unsigned long end) {
+        end = std::min(end, length);
+        start = std::min(start, end);
+        return std::shared_ptr<LasmList>(new LasmList(storage, offset + start, end - start));
+    }
+
+    std::shared_ptr<LasmList> LasmList::copy(unsigned long capacity) {
+        std::vector<LasmObject> values;
+        values.reserve(std::max(capacity, length));
+        values.insert(values.end(), begin(), end());
+        return std::make_shared<LasmList>(std::move(values));
+    }
+}
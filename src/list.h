@@ -0,0 +1,70 @@
+#ifndef __LIST_H__
+#define __LIST_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "object.h"
+
+namespace lasm {
+    /**
+     * Value of a list object.
+     * Lists derived by push, concat or slice share their elements with the original.
+     * A shared element buffer is copied before it is written to
+     */
+    class LasmList {
+        public:
+            typedef std::vector<LasmObject>::iterator iterator;
+
+            LasmList():
+                storage(std::make_shared<std::vector<LasmObject>>()) {}
+
+            LasmList(std::vector<LasmObject> &&values):
+                storage(std::make_shared<std::vector<LasmObject>>(std::move(values))),
+                length(storage->size()) {}
+
+            unsigned long size() { return length; }
+
+            LasmObject& at(unsigned long index) { return (*storage)[offset + index]; }
+
+            /**
+             * Assigns an element. Copies the elements first if another list shares them
+             */
+            void set(unsigned long index, const LasmObject &value);
+
+            iterator begin() { return storage->begin() + offset; }
+            iterator end() { return storage->begin() + offset + length; }
+
+            /**
+             * New list with value appended.
+             * Appends in place if no other list was grown from this one yet
+             */
+            std::shared_ptr<LasmList> push(const LasmObject &value);
+
+            std::shared_ptr<LasmList> concat(LasmList &other);
+
+            /**
+             * Elements from start up to but excluding end. Shares the elements of this list
+             */
+            std::shared_ptr<LasmList> slice(unsigned long start, unsigned long end);
+        private:
+            LasmList(std::shared_ptr<std::vector<LasmObject>> storage, unsigned long offset, unsigned long length):
+                storage(storage), offset(offset), length(length) {}
+
+            /**
+             * True if this list ends where its element buffer ends
+             */
+            bool canGrow() { return offset + length == storage->size(); }
+
+            /**
+             * Copy of the elements in a buffer of its own
+             */
+            std::shared_ptr<LasmList> copy(unsigned long capacity);
+
+            std::shared_ptr<std::vector<LasmObject>> storage;
+            unsigned long offset = 0;
+            unsigned long length = 0;
+    };
+}
+
+#endif
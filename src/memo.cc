@@ -0,0 +1,59 @@
+#include "memo.h"
+
+namespace lasm {
+    bool MemoTable::isCacheable(LasmObject &value) {
+        switch (value.getType()) {
+            case NIL_O:
+            case NUMBER_O:
+            case REAL_O:
+            case STRING_O:
+            case BOOLEAN_O:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool MemoTable::isCacheable(Arguments arguments) {
+        for (auto &argument : arguments) {
+            if (!isCacheable(argument)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool MemoTable::find(Arguments arguments, LasmObject &result) {
+        auto range = entries.equal_range(hash(arguments));
+        for (auto it = range.first; it != range.second; it++) {
+            auto &entry = it->second;
+            if (entry.arguments.size() != arguments.size()) {
+                continue;
+            }
+
+            bool equal = true;
+            for (unsigned long i = 0; i < arguments.size() && equal; i++) {
+                equal = entry.arguments[i].isEqual(arguments[i]);
+            }
+
+            if (equal) {
+                result = entry.result;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void MemoTable::insert(Arguments arguments, LasmObject &result) {
+        entries.insert(std::make_pair(hash(arguments),
+                    Entry(std::vector<LasmObject>(arguments.begin(), arguments.end()), result)));
+    }
+
+    size_t MemoTable::hash(Arguments arguments) {
+        size_t result = arguments.size();
+        for (auto &argument : arguments) {
+            result ^= argument.hash() + 0x9e3779b9 + (result << 6) + (result >> 2);
+        }
+        return result;
+    }
+}
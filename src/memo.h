@@ -0,0 +1,45 @@
+#ifndef __MEMO_H__
+#define __MEMO_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include "object.h"
+#include "callframe.h"
+
+namespace lasm {
+    /**
+     * Results of a pure function by argument tuple
+     */
+    class MemoTable {
+        public:
+            /**
+             * Only values that compare by value can be keys or results.
+             * Lists and callables are never cached
+             */
+            static bool isCacheable(LasmObject &value);
+            static bool isCacheable(Arguments arguments);
+
+            bool find(Arguments arguments, LasmObject &result);
+            void insert(Arguments arguments, LasmObject &result);
+
+            void clear() { entries.clear(); }
+            unsigned long size() { return entries.size(); }
+        private:
+            static size_t hash(Arguments arguments);
+
+            class Entry {
+                public:
+                    Entry(std::vector<LasmObject> arguments, LasmObject result):
+                        arguments(arguments), result(result) {}
+
+                    std::vector<LasmObject> arguments;
+                    LasmObject result;
+            };
+
+            std::unordered_multimap<size_t, Entry> entries;
+    };
+}
+
+#endif
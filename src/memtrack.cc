@@ -0,0 +1,146 @@
+#include "memtrack.h"
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+namespace lasm {
+    // zero initialized before any allocation can happen
+    static MemTracker::Counter counters[MEM_TAG_COUNT];
+#ifdef LASM_MEMTRACK
+    static thread_local MemTag currentTag = MEM_OTHER;
+#endif
+
+    const MemTracker::Counter& MemTracker::get(MemTag tag) {
+        return counters[tag];
+    }
+
+    void MemTracker::reset() {
+        for (auto &counter : counters) {
+            counter.allocations = 0;
+            counter.bytes = 0;
+            counter.peak = counter.live;
+        }
+    }
+
+    std::string MemTracker::tagToString(MemTag tag) {
+        switch (tag) {
+            case MEM_OTHER:
+                return "other";
+            case MEM_SCANNER:
+                return "scanner";
+            case MEM_PARSER:
+                return "parser";
+            case MEM_ENVIRONMENT:
+                return "environment";
+            case MEM_VALUES:
+                return "values";
+            case MEM_CODE:
+                return "code";
+            case MEM_WRITER:
+                return "writer";
+            default:
+                return "unknown";
+        }
+    }
+
+#ifdef LASM_MEMTRACK
+    bool MemTracker::isEnabled() {
+        return true;
+    }
+
+    MemTracker::Scope::Scope(MemTag tag):
+        previous(currentTag) {
+        currentTag = tag;
+    }
+
+    MemTracker::Scope::~Scope() {
+        currentTag = previous;
+    }
+#else
+    bool MemTracker::isEnabled() {
+        return false;
+    }
+#endif
+}
+
+#ifdef LASM_MEMTRACK
+namespace {
+    // keeps the block after it aligned for any type
+    struct alignas(std::max_align_t) Header {
+        std::size_t size;
+        lasm::MemTag tag;
+    };
+
+    void* allocate(std::size_t size) {
+        auto header = static_cast<Header*>(std::malloc(sizeof(Header) + size));
+        if (!header) {
+            return nullptr;
+        }
+        header->size = size;
+        header->tag = lasm::currentTag;
+
+        auto &counter = lasm::counters[header->tag];
+        counter.allocations++;
+        counter.bytes += size;
+        counter.live += size;
+        if (counter.live > counter.peak) {
+            counter.peak = counter.live;
+        }
+        return header + 1;
+    }
+
+    void release(void *ptr) {
+        if (!ptr) {
+            return;
+        }
+        // freed memory counts against the subsystem that allocated it
+        auto header = static_cast<Header*>(ptr) - 1;
+        lasm::counters[header->tag].live -= header->size;
+        std::free(header);
+    }
+}
+
+void* operator new(std::size_t size) {
+    auto ptr = allocate(size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    release(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    release(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t&) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t&) noexcept {
+    release(ptr);
+}
+#endif
@@ -0,0 +1,65 @@
+#ifndef __MEMTRACK_H__
+#define __MEMTRACK_H__
+
+#include <iostream>
+#include <string>
+#include "lasm_config.h"
+
+namespace lasm {
+    enum MemTag {
+        MEM_OTHER,
+        MEM_SCANNER,
+        MEM_PARSER,
+        MEM_ENVIRONMENT,
+        MEM_VALUES,
+        MEM_CODE,
+        MEM_WRITER,
+        MEM_TAG_COUNT
+    };
+
+    /**
+     * Accounts every heap allocation to the subsystem that made it.
+     * Only tracks if lasm was configured with --enable-memtrack.
+     * The global operator new and delete are replaced in that case
+     */
+    class MemTracker {
+        public:
+            class Counter {
+                public:
+                    unsigned long allocations;
+                    // all bytes that were ever allocated
+                    unsigned long bytes;
+                    unsigned long live;
+                    // highest value of live
+                    unsigned long peak;
+            };
+
+            /**
+             * Tags allocations with tag until the scope is left
+             */
+            class Scope {
+                public:
+#ifdef LASM_MEMTRACK
+                    Scope(MemTag tag);
+                    ~Scope();
+                private:
+                    MemTag previous;
+#else
+                    Scope(MemTag tag) {}
+#endif
+            };
+
+            static const Counter& get(MemTag tag);
+
+            /**
+             * Starts counting allocations and peaks from now on. Live bytes are kept
+             */
+            static void reset();
+
+            static std::string tagToString(MemTag tag);
+
+            static bool isEnabled();
+    };
+}
+
+#endif
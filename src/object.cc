@@ -1,11 +1,20 @@
 #include "object.h"
 #include "error.h"
+#include "range.h"
+#include <functional>
+#include <typeinfo>
 
 namespace lasm {
     LasmObject::LasmObject(ObjectType type, std::any value):
-        type(type), value(value) {}
+        type(type), value(value) {
+        // every string value is interned
+        if (type == STRING_O && value.type() == typeid(lasmString)) {
+            this->value = LasmString::make(std::any_cast<lasmString&>(value));
+        }
+    }
 
     LasmObject::LasmObject(LasmObject *original) {
+        LASM_STAT(objectCopies);
         type = original->type;
         value = original->value;
     }
@@ -36,8 +45,12 @@ namespace lasm {
         throw LasmTypeError(std::vector<ObjectType> {NUMBER_O, REAL_O}, type, std::shared_ptr<Token>(nullptr));
     }
 
-    lasmString& LasmObject::toString() {
-        return castTo<lasmString&>();
+    const lasmString& LasmObject::toString() {
+        return toLasmString()->get();
+    }
+
+    std::shared_ptr<LasmString> LasmObject::toLasmString() {
+        return castTo<std::shared_ptr<LasmString>>();
     }
 
     lasmBool LasmObject::toBool() {
@@ -52,8 +65,38 @@ namespace lasm {
         return castTo<std::shared_ptr<Callable>>();
     }
 
-    std::shared_ptr<std::vector<LasmObject>> LasmObject::toList() {
-        return castTo<std::shared_ptr<std::vector<LasmObject>>>();
+    std::shared_ptr<LasmList> LasmObject::toList() {
+        if (isRange()) {
+            return toRange()->toList();
+        }
+        return castTo<std::shared_ptr<LasmList>>();
+    }
+
+    std::shared_ptr<ByteArray> LasmObject::toBytes() {
+        return castTo<std::shared_ptr<ByteArray>>();
     }
-}
 
+    std::shared_ptr<LasmDict> LasmObject::toDict() {
+        return castTo<std::shared_ptr<LasmDict>>();
+    }
+
+    std::shared_ptr<LasmRange> LasmObject::toRange() {
+        return castTo<std::shared_ptr<LasmRange>>();
+    }
+
+    size_t LasmObject::hash() {
+        switch (type) {
+            case NUMBER_O:
+                return std::hash<lasmNumber>()(toNumber()) ^ type;
+            case REAL_O:
+                return std::hash<lasmReal>()(toReal()) ^ type;
+            case STRING_O:
+                return std::hash<LasmString*>()(toLasmString()->canonical()) ^ type;
+            case BOOLEAN_O:
+                return std::hash<lasmBool>()(toBool()) ^ type;
+            default:
+                // other types are never equal or all equal (nil)
+                return type;
+        }
+    }
+}
@@ -4,6 +4,8 @@
 #include <iostream>
 #include <any>
 #include "types.h"
+#include "lasmstring.h"
+#include "stats.h"
 #include <vector>
 #include <memory>
 
@@ -15,6 +17,10 @@ namespace lasm {
     typedef bool lasmBool;
     typedef std::nullptr_t lasmNil;
     class Callable;
+    class ByteArray;
+    class LasmList;
+    class LasmDict;
+    class LasmRange;
 
     enum ObjectType {
         NIL_O,
@@ -23,7 +29,10 @@ namespace lasm {
         STRING_O,
         BOOLEAN_O,
         CALLABLE_O,
-        LIST_O
+        LIST_O,
+        BYTES_O,
+        DICT_O,
+        RANGE_O
     };
 
     class LasmObject {
@@ -35,6 +44,22 @@ namespace lasm {
              */
             LasmObject(LasmObject *original);
 
+#ifdef LASM_STATS
+            LasmObject(const LasmObject &original):
+                type(original.type), value(original.value) {
+                LASM_STAT(objectCopies);
+            }
+            LasmObject(LasmObject &&original) = default;
+
+            LasmObject& operator=(const LasmObject &original) {
+                LASM_STAT(objectCopies);
+                type = original.type;
+                value = original.value;
+                return *this;
+            }
+            LasmObject& operator=(LasmObject &&original) = default;
+#endif
+
             template<typename T>
             T castTo() {
                 return std::any_cast<T>(value);
@@ -42,11 +67,15 @@ namespace lasm {
 
             lasmReal toReal();
             lasmNumber toNumber();
-            lasmString& toString();
+            const lasmString& toString();
+            std::shared_ptr<LasmString> toLasmString();
             lasmBool toBool();
             lasmNil toNil();
             std::shared_ptr<Callable> toCallable();
-            std::shared_ptr<std::vector<LasmObject>> toList();
+            std::shared_ptr<LasmList> toList();
+            std::shared_ptr<ByteArray> toBytes();
+            std::shared_ptr<LasmDict> toDict();
+            std::shared_ptr<LasmRange> toRange();
 
             bool isTruthy() {
                 if (isNil()) {
@@ -71,12 +100,16 @@ namespace lasm {
                     case REAL_O:
                         return toReal() == second.toReal();
                     case STRING_O:
-                        return toString() == second.toString();
+                        // interned strings are equal if they are the same node
+                        return toLasmString()->canonical() == second.toLasmString()->canonical();
                     case BOOLEAN_O:
                         return toBool() == second.toBool();
                     case CALLABLE_O:
                         return false;
                     case LIST_O:
+                    case BYTES_O:
+                    case DICT_O:
+                    case RANGE_O:
                         return false;
                 }
 
@@ -84,6 +117,11 @@ namespace lasm {
                 return false;
             }
 
+            /**
+             * Hash that is consistent with isEqual
+             */
+            size_t hash();
+
             ObjectType getType() {
                 return type;
             }
@@ -112,8 +150,30 @@ namespace lasm {
                 return type == CALLABLE_O;
             }
 
+            /**
+             * True for lists and ranges. toList turns a range into a list
+             */
             bool isList() {
-                return type == LIST_O;
+                return type == LIST_O || type == RANGE_O;
+            }
+
+            bool isBytes() {
+                return type == BYTES_O;
+            }
+
+            bool isDict() {
+                return type == DICT_O;
+            }
+
+            bool isRange() {
+                return type == RANGE_O;
+            }
+
+            /**
+             * True for values that can change without being reassigned
+             */
+            bool isMutable() {
+                return type == LIST_O || type == BYTES_O || type == DICT_O || type == RANGE_O;
             }
 
             bool isScalar();
@@ -122,6 +182,11 @@ namespace lasm {
             std::any value;
     };
 
+    template<>
+    inline lasmString LasmObject::castTo<lasmString>() {
+        return toString();
+    }
+
 }
 
 #endif
@@ -0,0 +1,302 @@
+#include "optimizer.h"
+
+namespace lasm {
+    Optimizer::Optimizer(BaseError &onError, BaseInstructionSet &instructions, bool globalScope):
+        interpreter(onError, instructions), globalScope(globalScope) {
+    }
+
+    void Optimizer::optimize(std::vector<std::shared_ptr<Stmt>> &stmts) {
+        std::vector<std::shared_ptr<Stmt>> result;
+        result.reserve(stmts.size());
+        depth++;
+
+        for (auto &stmt : stmts) {
+            // statements that failed to parse are kept as they are
+            if (!stmt.get()) {
+                result.push_back(stmt);
+                continue;
+            }
+
+            auto replacement = rewrite(stmt);
+            if (replacement.get()) {
+                result.push_back(replacement);
+            }
+        }
+
+        depth--;
+        stmts = result;
+    }
+
+    void Optimizer::optimize(std::shared_ptr<Stmt> &stmt) {
+        if (!stmt.get()) {
+            return;
+        }
+
+        auto replacement = rewrite(stmt);
+        if (!replacement.get()) {
+            replacement = std::make_shared<BlockStmt>(BlockStmt(std::vector<std::shared_ptr<Stmt>>()));
+        }
+        stmt = replacement;
+    }
+
+    std::shared_ptr<Stmt> Optimizer::rewrite(const std::shared_ptr<Stmt> &stmt) {
+        auto result = stmt->accept(this);
+        if (result.type() == typeid(std::shared_ptr<Stmt>)) {
+            return std::any_cast<std::shared_ptr<Stmt>>(result);
+        }
+        return stmt;
+    }
+
+    void Optimizer::fold(std::shared_ptr<Expr> &expr) {
+        if (!expr.get()) {
+            return;
+        }
+
+        auto result = expr->accept(this);
+        if (result.type() == typeid(std::shared_ptr<Expr>)) {
+            expr = std::any_cast<std::shared_ptr<Expr>>(result);
+        }
+    }
+
+    void Optimizer::fold(std::vector<std::shared_ptr<Expr>> &exprs) {
+        for (auto &expr : exprs) {
+            fold(expr);
+        }
+    }
+
+    bool Optimizer::isLiteral(const std::shared_ptr<Expr> &expr) {
+        return expr.get() && dynamic_cast<LiteralExpr*>(expr.get());
+    }
+
+    LasmObject& Optimizer::literalValue(const std::shared_ptr<Expr> &expr) {
+        return static_cast<LiteralExpr*>(expr.get())->value;
+    }
+
+    std::any Optimizer::evaluate(Expr *expr) {
+        try {
+            auto value = std::any_cast<LasmObject>(expr->accept(&interpreter));
+            return std::static_pointer_cast<Expr>(std::make_shared<LiteralExpr>(LiteralExpr(value)));
+        } catch (LasmException &e) {
+            // keep the expression. the interpreter reports the error
+            return std::any();
+        }
+    }
+
+    std::any Optimizer::visitBinary(BinaryExpr *expr) {
+        fold(expr->left);
+        fold(expr->right);
+
+        if (isLiteral(expr->left) && isLiteral(expr->right)) {
+            return evaluate(expr);
+        }
+        return std::any();
+    }
+
+    std::any Optimizer::visitUnary(UnaryExpr *expr) {
+        fold(expr->right);
+
+        if (isLiteral(expr->right)) {
+            return evaluate(expr);
+        }
+        return std::any();
+    }
+
+    std::any Optimizer::visitLiteral(LiteralExpr *expr) {
+        return std::any();
+    }
+
+    std::any Optimizer::visitGrouping(GroupingExpr *expr) {
+        fold(expr->expression);
+
+        if (isLiteral(expr->expression)) {
+            return expr->expression;
+        }
+        return std::any();
+    }
+
+    std::any Optimizer::visitVariable(VariableExpr *expr) {
+        // global constants can not be shadowed, every later use is the constant
+        auto it = constants.find(expr->name->getLexeme());
+        if (it != constants.end()) {
+            return std::static_pointer_cast<Expr>(std::make_shared<LiteralExpr>(LiteralExpr(it->second)));
+        }
+        return std::any();
+    }
+
+    std::any Optimizer::visitAssign(AssignExpr *expr) {
+        fold(expr->value);
+        return std::any();
+    }
+
+    std::any Optimizer::visitLogical(LogicalExpr *expr) {
+        fold(expr->left);
+        fold(expr->right);
+
+        // the result is either the left literal or whatever the right side is
+        if (isLiteral(expr->left)) {
+            bool truthy = literalValue(expr->left).isTruthy();
+            if ((expr->op->getType() == OR) == truthy) {
+                return expr->left;
+            }
+            return expr->right;
+        }
+        return std::any();
+    }
+
+    std::any Optimizer::visitCall(CallExpr *expr) {
+        fold(expr->callee);
+        fold(expr->arguments);
+        return std::any();
+    }
+
+    std::any Optimizer::visitList(ListExpr *expr) {
+        // lists are never folded. every evaluation creates a new list
+        fold(expr->list);
+        return std::any();
+    }
+
+    std::any Optimizer::visitIndex(IndexExpr *expr) {
+        fold(expr->object);
+        fold(expr->index);
+
+        if (isLiteral(expr->object) && isLiteral(expr->index)) {
+            return evaluate(expr);
+        }
+        return std::any();
+    }
+
+    std::any Optimizer::visitIndexAssign(IndexAssignExpr *expr) {
+        fold(expr->object);
+        fold(expr->index);
+        fold(expr->value);
+        return std::any();
+    }
+
+    std::any Optimizer::visitExpression(ExpressionStmt *stmt) {
+        fold(stmt->expr);
+        return std::any();
+    }
+
+    std::any Optimizer::visitLet(LetStmt *stmt) {
+        fold(stmt->init);
+
+        if (stmt->constant && globalScope && depth == 1 && isLiteral(stmt->init)) {
+            constants.insert(std::make_pair(stmt->name->getLexeme(), literalValue(stmt->init)));
+            snapshot.reset();
+        }
+        return std::any();
+    }
+
+    std::any Optimizer::visitBlock(BlockStmt *stmt) {
+        optimize(stmt->statements);
+        return std::any();
+    }
+
+    std::any Optimizer::visitIf(IfStmt *stmt) {
+        fold(stmt->condition);
+        optimize(stmt->thenBranch);
+        optimize(stmt->elseBranch);
+
+        if (isLiteral(stmt->condition)) {
+            if (literalValue(stmt->condition).isTruthy()) {
+                return stmt->thenBranch;
+            }
+            return stmt->elseBranch;
+        }
+        return std::any();
+    }
+
+    std::any Optimizer::visitWhile(WhileStmt *stmt) {
+        fold(stmt->condition);
+        optimize(stmt->body);
+
+        if (isLiteral(stmt->condition) && !literalValue(stmt->condition).isTruthy()) {
+            return std::shared_ptr<Stmt>(nullptr);
+        }
+        return std::any();
+    }
+
+    std::any Optimizer::visitForIn(ForInStmt *stmt) {
+        fold(stmt->iterable);
+        optimize(stmt->body);
+        return std::any();
+    }
+
+    std::any Optimizer::visitFunction(FunctionStmt *stmt) {
+        if (stmt->lazyBody.get()) {
+            // functions declared between two constants share a copy
+            if (!snapshot.get()) {
+                snapshot = std::make_shared<const ConstantTable>(constants);
+            }
+            stmt->lazyBody->constants = snapshot;
+            return std::any();
+        }
+
+        optimize(stmt->body);
+        return std::any();
+    }
+
+    void Optimizer::inlineConstants(const ConstantTable &constants) {
+        this->constants.insert(constants.begin(), constants.end());
+        snapshot.reset();
+    }
+
+    std::any Optimizer::visitReturn(ReturnStmt *stmt) {
+        fold(stmt->value);
+        return std::any();
+    }
+
+    std::any Optimizer::visitLabel(LabelStmt *stmt) {
+        return std::any();
+    }
+
+    std::any Optimizer::visitInstruction(InstructionStmt *stmt) {
+        fold(stmt->args);
+        return std::any();
+    }
+
+    std::any Optimizer::visitDirective(DirectiveStmt *stmt) {
+        fold(stmt->args);
+        return std::any();
+    }
+
+    std::any Optimizer::visitAlign(AlignStmt *stmt) {
+        fold(stmt->alignTo);
+        fold(stmt->fillValue);
+        return std::any();
+    }
+
+    std::any Optimizer::visitFill(FillStmt *stmt) {
+        fold(stmt->fillAddress);
+        fold(stmt->fillValue);
+        return std::any();
+    }
+
+    std::any Optimizer::visitOrg(OrgStmt *stmt) {
+        fold(stmt->address);
+        return std::any();
+    }
+
+    std::any Optimizer::visitDefineByte(DefineByteStmt *stmt) {
+        fold(stmt->values);
+        return std::any();
+    }
+
+    std::any Optimizer::visitBss(BssStmt *stmt) {
+        fold(stmt->startAddress);
+        for (auto &declaration : stmt->declarations) {
+            fold(declaration->init);
+        }
+        return std::any();
+    }
+
+    std::any Optimizer::visitIncbin(IncbinStmt *stmt) {
+        fold(stmt->filePath);
+        return std::any();
+    }
+
+    std::any Optimizer::visitInclude(IncludeStmt *stmt) {
+        fold(stmt->filePath);
+        return std::any();
+    }
+}
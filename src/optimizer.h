@@ -0,0 +1,105 @@
+#ifndef __OPTIMIZER_H__
+#define __OPTIMIZER_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <any>
+#include <map>
+#include "expr.h"
+#include "stmt.h"
+#include "error.h"
+#include "instruction.h"
+#include "interpreter.h"
+
+namespace lasm {
+    /**
+     * Rewrites a parsed program before it is interpreted.
+     * Subtrees that only consist of literals are folded into a single literal
+     * and if or while statements with literal conditions are pruned.
+     * Uses of global constants with a literal value are replaced by the value.
+     * Anything that fails to evaluate is left alone so the error is still
+     * reported when the interpreter reaches it.
+     */
+    class Optimizer: public ExprVisitor, public StmtVisitor {
+        public:
+            /**
+             * globalScope is set if the top level statements are executed in the global environment
+             */
+            Optimizer(BaseError &onError, BaseInstructionSet &instructions, bool globalScope=true);
+
+            void optimize(std::vector<std::shared_ptr<Stmt>> &stmts);
+
+            /**
+             * Global constants that were declared before the optimized statements
+             */
+            void inlineConstants(const ConstantTable &constants);
+
+            std::any visitBinary(BinaryExpr *expr);
+            std::any visitUnary(UnaryExpr *expr);
+            std::any visitLiteral(LiteralExpr *expr);
+            std::any visitGrouping(GroupingExpr *expr);
+            std::any visitVariable(VariableExpr *expr);
+            std::any visitAssign(AssignExpr *expr);
+            std::any visitLogical(LogicalExpr *expr);
+            std::any visitCall(CallExpr *expr);
+            std::any visitList(ListExpr *expr);
+            std::any visitIndex(IndexExpr *expr);
+            std::any visitIndexAssign(IndexAssignExpr *expr);
+
+            std::any visitExpression(ExpressionStmt *stmt);
+            std::any visitLet(LetStmt *stmt);
+            std::any visitBlock(BlockStmt *stmt);
+            std::any visitIf(IfStmt *stmt);
+            std::any visitWhile(WhileStmt *stmt);
+            std::any visitForIn(ForInStmt *stmt);
+            std::any visitFunction(FunctionStmt *stmt);
+            std::any visitReturn(ReturnStmt *stmt);
+            std::any visitLabel(LabelStmt *stmt);
+            std::any visitInstruction(InstructionStmt *stmt);
+            std::any visitDirective(DirectiveStmt *stmt);
+            std::any visitAlign(AlignStmt *stmt);
+            std::any visitFill(FillStmt *stmt);
+            std::any visitOrg(OrgStmt *stmt);
+            std::any visitDefineByte(DefineByteStmt *stmt);
+            std::any visitBss(BssStmt *stmt);
+            std::any visitIncbin(IncbinStmt *stmt);
+            std::any visitInclude(IncludeStmt *stmt);
+        private:
+            /**
+             * Optimizes a statement in a position that requires a statement.
+             * Removed statements become an empty block
+             */
+            void optimize(std::shared_ptr<Stmt> &stmt);
+
+            /**
+             * Returns the replacement of stmt. nullptr if it was removed
+             */
+            std::shared_ptr<Stmt> rewrite(const std::shared_ptr<Stmt> &stmt);
+
+            void fold(std::shared_ptr<Expr> &expr);
+            void fold(std::vector<std::shared_ptr<Expr>> &exprs);
+
+            bool isLiteral(const std::shared_ptr<Expr> &expr);
+            LasmObject& literalValue(const std::shared_ptr<Expr> &expr);
+
+            /**
+             * Evaluates an expression whose operands are literals.
+             * Returns an empty value if the evaluation fails
+             */
+            std::any evaluate(Expr *expr);
+
+            Interpreter interpreter;
+
+            bool globalScope;
+            // statement lists that are being optimized. 1 for top level statements
+            unsigned int depth = 0;
+
+            // global constants that were declared so far
+            ConstantTable constants;
+            // copy of constants for lazy function bodies
+            std::shared_ptr<const ConstantTable> snapshot;
+    };
+}
+
+#endif
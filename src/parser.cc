@@ -1,4 +1,5 @@
 #include "parser.h"
+#include "utility.h"
 
 namespace lasm {
     Parser::Parser(BaseError &error, std::vector<std::shared_ptr<Token>> &tokens, BaseInstructionSet &instructions):
@@ -19,8 +20,13 @@ namespace lasm {
         try {
             if (match(std::vector<TokenType> {LET})) {
                 return letDeclaration();
+            } else if (match(std::vector<TokenType> {CONST})) {
+                return letDeclaration(true);
             } else if (match(std::vector<TokenType> {FUNCTION})) {
                 return functionDeclaration();
+            } else if (match(std::vector<TokenType> {PURE})) {
+                consume(FUNCTION, MISSING_FUNCTION);
+                return functionDeclaration(true);
             } else if (match(std::vector<TokenType> {LABEL})) {
                 return labelDeclaration();
             }
@@ -32,19 +38,21 @@ namespace lasm {
         }
     }
 
-    std::shared_ptr<Stmt> Parser::letDeclaration() {
+    std::shared_ptr<Stmt> Parser::letDeclaration(bool constant) {
         auto name = consume(IDENTIFIER, MISSING_IDENTIFIER);
 
         std::shared_ptr<Expr> init = std::shared_ptr<Expr>(nullptr);
         if (match(std::vector<TokenType> {EQUAL})) {
             init = expression();
+        } else if (constant) {
+            throw ParserException(name, CONST_WITHOUT_VALUE);
         }
 
         consume(SEMICOLON, MISSING_SEMICOLON);
-        return std::make_shared<LetStmt>(LetStmt(name, init));
+        return std::make_shared<LetStmt>(LetStmt(name, init, constant));
     }
 
-    std::shared_ptr<Stmt> Parser::functionDeclaration() {
+    std::shared_ptr<Stmt> Parser::functionDeclaration(bool pure) {
         auto name = consume(IDENTIFIER, MISSING_IDENTIFIER);
         consume(LEFT_PAREN, MISSING_LEFT_PAREN);
         std::vector<std::shared_ptr<Token>> params;
@@ -57,9 +65,38 @@ namespace lasm {
 
         consume(RIGHT_PAREN, MISSING_RIHGT_PAREN);
         consume(LEFT_BRACE, BLOCK_NOT_OPENED_ERROR);
-        auto body = block();
 
-        return std::make_shared<FunctionStmt>(name, params, body);
+        // the body is only kept as tokens until the function is called.
+        // an unclosed body is parsed right away to report the error
+        auto end = blockEnd();
+        if (!end) {
+            auto body = block();
+            return std::make_shared<FunctionStmt>(name, params, body, pure);
+        }
+
+        auto lazy = std::make_shared<LazyBody>(onError, instructions);
+        lazy->tokens.assign(tokens.begin() + current, tokens.begin() + end);
+        auto closing = tokens.at(end);
+        lazy->tokens.push_back(std::make_shared<Token>(Token(EOF_T, "", LasmObject(NIL_O, nullptr),
+                        closing->getLine(), closing->getPath(), closing->getTokenStart(), closing->getSource())));
+        current = end + 1;
+
+        auto stmt = std::make_shared<FunctionStmt>(name, params, std::vector<std::shared_ptr<Stmt>>(), pure);
+        stmt->lazyBody = lazy;
+        return stmt;
+    }
+
+    unsigned long Parser::blockEnd() {
+        unsigned long depth = 1;
+        for (auto i = current; i < tokens.size(); i++) {
+            auto type = tokens.at(i)->getType();
+            if (type == LEFT_BRACE) {
+                depth++;
+            } else if (type == RIGHT_BRACE && --depth == 0) {
+                return i;
+            }
+        }
+        return 0;
     }
 
     std::shared_ptr<Stmt> Parser::labelDeclaration() {
@@ -117,8 +154,13 @@ namespace lasm {
     }
 
     std::shared_ptr<Stmt> Parser::forStatement() {
+        auto keyword = previous();
         consume(LEFT_PAREN, MISSING_LEFT_PAREN);
 
+        if (check(IDENTIFIER) && checkNext(IN)) {
+            return forInStatement();
+        }
+
         std::shared_ptr<Stmt> init;
         if (match(std::vector<TokenType> {SEMICOLON})) {
             init = std::shared_ptr<Stmt>(nullptr);
@@ -151,7 +193,7 @@ namespace lasm {
         if (!condition.get()) {
             condition = std::make_shared<LiteralExpr>(LasmObject(BOOLEAN_O, true));
         }
-        body = std::make_shared<WhileStmt>(condition, body);
+        body = std::make_shared<WhileStmt>(condition, body, keyword);
 
         if (init.get()) {
             body = std::make_shared<BlockStmt>(std::vector<std::shared_ptr<Stmt>>
@@ -161,13 +203,25 @@ namespace lasm {
         return body;
     }
 
+    std::shared_ptr<Stmt> Parser::forInStatement() {
+        auto name = advance();
+        // in
+        advance();
+        auto iterable = expression();
+        consume(RIGHT_PAREN, MISSING_RIHGT_PAREN);
+        auto body = statement();
+
+        return std::make_shared<ForInStmt>(name, iterable, body);
+    }
+
     std::shared_ptr<Stmt> Parser::whileStatement() {
+        auto keyword = previous();
         consume(LEFT_PAREN, MISSING_LEFT_PAREN);
         auto condition = expression();
         consume(RIGHT_PAREN, MISSING_RIHGT_PAREN);
         auto body = statement();
 
-        return std::make_shared<WhileStmt>(condition, body);
+        return std::make_shared<WhileStmt>(condition, body, keyword);
     }
 
     std::shared_ptr<Stmt> Parser::ifStatement() {
@@ -222,6 +276,11 @@ namespace lasm {
 
     std::shared_ptr<Stmt> Parser::defineNByteStatement(unsigned short size, Endianess endianess) {
         auto token = previous();
+        auto packed = packedDefineStatement(token, size, endianess);
+        if (packed.get()) {
+            return packed;
+        }
+
         std::vector<std::shared_ptr<Expr>> values;
         do {
             values.push_back(expression());
@@ -231,6 +290,46 @@ namespace lasm {
         return std::make_shared<DefineByteStmt>(DefineByteStmt(token, values, size, endianess));
     }
 
+    std::shared_ptr<Stmt> Parser::packedDefineStatement(std::shared_ptr<Token> token,
+            unsigned short size, Endianess endianess) {
+        if (size != 1 && size != 2 && size != 4 && size != 8) {
+            return std::shared_ptr<Stmt>(nullptr);
+        }
+
+        // every value has to be an integer literal, optionally negated.
+        // reals keep their own encoding in the interpreter
+        unsigned long count = 0;
+        for (unsigned long i = current;; i += 2) {
+            if (tokens.at(i)->getType() == MINUS) {
+                i++;
+            }
+            if (tokens.at(i)->getType() != NUMBER || !tokens.at(i)->getLiteral().isNumber()) {
+                return std::shared_ptr<Stmt>(nullptr);
+            }
+            count++;
+
+            auto next = tokens.at(i+1)->getType();
+            if (next == SEMICOLON) {
+                break;
+            } else if (next != COMMA) {
+                return std::shared_ptr<Stmt>(nullptr);
+            }
+        }
+
+        auto stmt = std::make_shared<DefineByteStmt>(DefineByteStmt(token,
+                    std::vector<std::shared_ptr<Expr>>(), size, endianess));
+        stmt->packedSize = count * size;
+        stmt->packed = std::shared_ptr<char[]>(new char[stmt->packedSize]);
+        for (unsigned long i = 0; i < count; i++) {
+            bool negative = match(std::vector<TokenType> {MINUS});
+            auto value = advance()->getLiteral().toNumber();
+            encodeNumber(stmt->packed.get() + i * size, negative ? -value : value, size, endianess);
+            // comma or semicolon
+            advance();
+        }
+        return stmt;
+    }
+
     std::shared_ptr<Stmt> Parser::defineByteStatement() {
         return defineNByteStatement(1, instructions.getEndianess());
     }
@@ -518,6 +617,10 @@ namespace lasm {
         return !isAtEnd() && peek()->getType() == type;
     }
 
+    bool Parser::checkNext(TokenType type) {
+        return !isAtEnd() && current + 1 < tokens.size() && tokens.at(current+1)->getType() == type;
+    }
+
     std::shared_ptr<Token> Parser::advance() {
         if (!isAtEnd()) {
             current++;
@@ -556,7 +659,9 @@ namespace lasm {
 
             switch (peek()->getType()) {
                 case FUNCTION:
+                case PURE:
                 case LET:
+                case CONST:
                 case FOR:
                 case IF:
                 case WHILE:
@@ -20,6 +20,7 @@ namespace lasm {
 
             bool match(std::vector<TokenType> types);
             bool check(TokenType type);
+            bool checkNext(TokenType type);
             std::shared_ptr<Token> advance();
 
             bool isAtEnd();
@@ -30,22 +31,36 @@ namespace lasm {
 
         private:
             std::shared_ptr<Stmt> declaration();
-            std::shared_ptr<Stmt> letDeclaration();
-            std::shared_ptr<Stmt> functionDeclaration();
+            std::shared_ptr<Stmt> letDeclaration(bool constant=false);
+            std::shared_ptr<Stmt> functionDeclaration(bool pure=false);
             std::shared_ptr<Stmt> labelDeclaration();
             std::shared_ptr<Stmt> statement();
 
             std::shared_ptr<Stmt> forStatement();
+            std::shared_ptr<Stmt> forInStatement();
             std::shared_ptr<Stmt> whileStatement();
             std::shared_ptr<Stmt> ifStatement();
             std::shared_ptr<Stmt> returnStatement();
             std::vector<std::shared_ptr<Stmt>> block();
+
+            /**
+             * Index of the brace that closes the block that was just opened.
+             * 0 if the block is not closed
+             */
+            unsigned long blockEnd();
             std::shared_ptr<Stmt> expressionStatement();
             std::shared_ptr<Stmt> orgDirective();
             std::shared_ptr<Stmt> fillDirective();
             std::shared_ptr<Stmt> alignDirective();
 
             std::shared_ptr<Stmt> defineNByteStatement(unsigned short size, Endianess endianess=LITTLE);
+
+            /**
+             * A db statement with its values already encoded
+             * or nullptr if a value is not a number literal
+             */
+            std::shared_ptr<Stmt> packedDefineStatement(std::shared_ptr<Token> token,
+                    unsigned short size, Endianess endianess);
             std::shared_ptr<Stmt> defineByteStatement();
             std::shared_ptr<Stmt> defineHalfWorldStatement();
             std::shared_ptr<Stmt> defineWordStatement();
@@ -0,0 +1,38 @@
+#include "phasetimer.h"
+#include <sys/resource.h>
+
+namespace lasm {
+    unsigned long PhaseTimer::indexOf(const std::string &name, const std::string &file) {
+        // there are only a few phases per file
+        for (unsigned long i = 0; i < phases.size(); i++) {
+            if (phases[i].name == name && phases[i].file == file) {
+                return i;
+            }
+        }
+
+        phases.push_back(Phase(name, file));
+        return phases.size() - 1;
+    }
+
+    void PhaseTimer::add(unsigned long index, Clock::time_point wallStart, double cpu) {
+        std::chrono::duration<double> wall = Clock::now() - wallStart;
+        if (tracing) {
+            std::chrono::duration<double> start = wallStart - origin;
+            spans.push_back(Span(index, start.count(), wall.count()));
+        }
+
+        auto &phase = phases[index];
+        phase.wall += wall.count();
+        phase.cpu += cpu;
+        phase.count++;
+    }
+
+    long PhaseTimer::getPeakRss() {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+        // kilobytes on linux
+        return usage.ru_maxrss;
+    }
+}
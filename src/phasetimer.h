@@ -0,0 +1,110 @@
+#ifndef __PHASETIMER_H__
+#define __PHASETIMER_H__
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <ctime>
+
+namespace lasm {
+    /**
+     * Wall and CPU time of the phases of an assembly.
+     * Phases with the same name and file add up.
+     * If tracing is on every single run of a phase is kept as a span as well
+     */
+    class PhaseTimer {
+        public:
+            typedef std::chrono::steady_clock Clock;
+
+            PhaseTimer(bool tracing=false):
+                tracing(tracing), origin(Clock::now()) {}
+
+            class Phase {
+                public:
+                    Phase(std::string name, std::string file):
+                        name(name), file(file) {}
+
+                    std::string name;
+                    // empty for phases that are not about a single file
+                    std::string file;
+                    // seconds
+                    double wall = 0;
+                    double cpu = 0;
+                    unsigned long count = 0;
+            };
+
+            /**
+             * One run of a phase
+             */
+            class Span {
+                public:
+                    Span(unsigned long phase, double start, double duration):
+                        phase(phase), start(start), duration(duration) {}
+
+                    // index into phases
+                    unsigned long phase;
+                    // seconds since the timer was created
+                    double start;
+                    double duration;
+            };
+
+            /**
+             * Times a phase until the scope is left. Does nothing without a timer
+             */
+            class Scope {
+                public:
+                    Scope(PhaseTimer *timer, const std::string &name, const std::string &file=""):
+                        timer(timer) {
+                        if (timer) {
+                            index = timer->indexOf(name, file);
+                            wallStart = Clock::now();
+                            cpuStart = std::clock();
+                        }
+                    }
+
+                    ~Scope() {
+                        if (timer) {
+                            timer->add(index, wallStart, (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC);
+                        }
+                    }
+                private:
+                    PhaseTimer *timer;
+                    unsigned long index = 0;
+                    Clock::time_point wallStart;
+                    std::clock_t cpuStart = 0;
+            };
+
+            /**
+             * Index of the phase. Adds it if it was not started before
+             */
+            unsigned long indexOf(const std::string &name, const std::string &file);
+
+            /**
+             * Adds a run of the phase that started at wallStart and ends now
+             */
+            void add(unsigned long index, Clock::time_point wallStart, double cpu);
+
+            /**
+             * Phases in the order they were first started
+             */
+            const std::vector<Phase>& getPhases() { return phases; }
+
+            /**
+             * Runs of phases in the order they ended. Empty if tracing is off
+             */
+            const std::vector<Span>& getSpans() { return spans; }
+
+            /**
+             * Largest resident set size of the process in kilobytes. 0 if unknown
+             */
+            static long getPeakRss();
+        private:
+            std::vector<Phase> phases;
+            std::vector<Span> spans;
+            bool tracing;
+            Clock::time_point origin;
+    };
+}
+
+#endif
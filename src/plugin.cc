@@ -0,0 +1,41 @@
+#include "plugin.h"
+#include "interpreter.h"
+#include <dlfcn.h>
+
+namespace lasm {
+    void PluginRegistry::define(const std::string &name, std::shared_ptr<Callable> callable) {
+        interpreter.defineBuiltin(name, callable);
+    }
+
+    PluginLoader::~PluginLoader() {
+        for (auto handle : handles) {
+            dlclose(handle);
+        }
+    }
+
+    void PluginLoader::load(const std::string &path, Interpreter &interpreter) {
+        auto handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!handle) {
+            error = dlerror();
+            throw LasmException(PLUGIN_ERROR);
+        }
+
+        auto version = (LasmPluginVersion)dlsym(handle, "lasm_plugin_version");
+        auto init = (LasmPluginInit)dlsym(handle, "lasm_plugin_init");
+        if (!version || !init) {
+            error = "missing lasm_plugin_version or lasm_plugin_init";
+            dlclose(handle);
+            throw LasmException(PLUGIN_ERROR);
+        } else if (version() != LASM_PLUGIN_VERSION) {
+            error = "built for plugin version " + std::to_string(version())
+                + ", expected " + std::to_string(LASM_PLUGIN_VERSION)
+                + ". configure options of lasm and the plugin must match";
+            dlclose(handle);
+            throw LasmException(PLUGIN_ERROR);
+        }
+
+        handles.push_back(handle);
+        PluginRegistry registry(interpreter);
+        init(&registry);
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef __PLUGIN_H__
+#define __PLUGIN_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include "lasm_config.h"
+#include "callable.h"
+#include "bytearray.h"
+
+// configure options that change classes or inline code plugins share with lasm
+#ifdef LASM_STATS
+#define LASM_PLUGIN_STATS 0x10000
+#else
+#define LASM_PLUGIN_STATS 0
+#endif
+
+#ifdef LASM_MEMTRACK
+#define LASM_PLUGIN_MEMTRACK 0x20000
+#else
+#define LASM_PLUGIN_MEMTRACK 0
+#endif
+
+// plugins built against another version or with other options are not loaded
+#define LASM_PLUGIN_VERSION (1 | LASM_PLUGIN_STATS | LASM_PLUGIN_MEMTRACK)
+
+namespace lasm {
+    class Interpreter;
+
+    /**
+     * Handed to the init function of a plugin.
+     * Callables defined here are global builtins
+     */
+    class PluginRegistry {
+        public:
+            PluginRegistry(Interpreter &interpreter):
+                interpreter(interpreter) {}
+
+            void define(const std::string &name, std::shared_ptr<Callable> callable);
+
+            template<typename T, typename... Args>
+            void define(const std::string &name, Args... args) {
+                define(name, std::static_pointer_cast<Callable>(std::make_shared<T>(args...)));
+            }
+        private:
+            Interpreter &interpreter;
+    };
+
+    /**
+     * Shared objects given with -plugin.
+     * They stay loaded until the loader is destroyed,
+     * so it has to outlive every interpreter it loaded plugins into
+     */
+    class PluginLoader {
+        public:
+            PluginLoader() {}
+            PluginLoader(const PluginLoader&) = delete;
+            ~PluginLoader();
+
+            /**
+             * Throws PLUGIN_ERROR if path can not be loaded
+             */
+            void load(const std::string &path, Interpreter &interpreter);
+
+            std::string getError() { return error; }
+        private:
+            std::vector<void*> handles;
+            std::string error = "";
+    };
+}
+
+extern "C" {
+    typedef int (*LasmPluginVersion)();
+    typedef void (*LasmPluginInit)(lasm::PluginRegistry *registry);
+}
+
+/**
+ * Defines the entry points of a plugin:
+ * LASM_PLUGIN(registry) {
+ *     registry->define<MyBuiltin>("mybuiltin");
+ * }
+ */
+#define LASM_PLUGIN(registry) \
+    extern "C" int lasm_plugin_version() { return LASM_PLUGIN_VERSION; } \
+    extern "C" void lasm_plugin_init(lasm::PluginRegistry *registry)
+
+#endif
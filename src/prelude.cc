@@ -0,0 +1,66 @@
+#include "prelude.h"
+
+namespace lasm {
+    void Prelude::begin(std::shared_ptr<Environment> globals) {
+        statements.clear();
+        bindings.clear();
+        open = true;
+
+        for (auto &value : globals->getValues()) {
+            capture(globals, value.first);
+        }
+    }
+
+    bool Prelude::add(Stmt *stmt, std::shared_ptr<Environment> globals, const std::vector<std::string> &names) {
+        // a list or array could be changed by later statements of the pass
+        for (auto &name : names) {
+            auto it = globals->getValues().find(name);
+            if (it == globals->getValues().end() || it->second->isMutable()) {
+                open = false;
+                return false;
+            }
+        }
+
+        for (auto &name : names) {
+            capture(globals, name);
+        }
+        statements.push_back(stmt);
+        return true;
+    }
+
+    bool Prelude::matches(const std::vector<std::shared_ptr<Stmt>> &stmts) {
+        if (bindings.empty() || stmts.size() < statements.size()) {
+            return false;
+        }
+
+        for (unsigned long i = 0; i < statements.size(); i++) {
+            if (stmts[i].get() != statements[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Prelude::restore(std::shared_ptr<Environment> globals) {
+        globals->clear();
+        for (auto &binding : bindings) {
+            // every pass gets its own copy of the value
+            LasmObject value = binding.second.value;
+            if (binding.second.constant) {
+                globals->defineConstant(binding.first, value);
+            } else {
+                globals->define(binding.first, value);
+            }
+        }
+    }
+
+    void Prelude::capture(std::shared_ptr<Environment> globals, const std::string &name) {
+        auto value = globals->getValues().find(name)->second;
+
+        auto it = bindings.find(name);
+        if (it != bindings.end()) {
+            bindings.erase(it);
+        }
+        bindings.insert(std::make_pair(name, Binding(*value, globals->isConstant(name))));
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef __PRELUDE_H__
+#define __PRELUDE_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <map>
+#include "object.h"
+#include "stmt.h"
+#include "environment.h"
+
+namespace lasm {
+    /**
+     * Leading top level statements that do not depend on the address or labels.
+     * They only run in the first pass. Later passes start with the global bindings
+     * they left behind.
+     */
+    class Prelude {
+        public:
+            /**
+             * Starts a new prelude with the bindings that exist in globals
+             */
+            void begin(std::shared_ptr<Environment> globals);
+
+            /**
+             * Adds an executed statement and the bindings it defined.
+             * Returns false and closes the prelude if a binding can not be kept
+             */
+            bool add(Stmt *stmt, std::shared_ptr<Environment> globals, const std::vector<std::string> &names);
+
+            void close() { open = false; }
+            bool isOpen() { return open; }
+
+            /**
+             * True if stmts starts with the statements of this prelude
+             */
+            bool matches(const std::vector<std::shared_ptr<Stmt>> &stmts);
+
+            void restore(std::shared_ptr<Environment> globals);
+
+            unsigned long size() { return statements.size(); }
+        private:
+            class Binding {
+                public:
+                    Binding(LasmObject value, bool constant):
+                        value(value), constant(constant) {}
+
+                    LasmObject value;
+                    bool constant;
+            };
+
+            void capture(std::shared_ptr<Environment> globals, const std::string &name);
+
+            std::vector<Stmt*> statements;
+            std::map<std::string, Binding> bindings;
+            bool open = false;
+    };
+}
+
+#endif
@@ -0,0 +1,116 @@
+#include "profiler.h"
+#include <algorithm>
+
+namespace lasm {
+    Profiler::Profiler():
+        root(nullptr) {}
+
+    void Profiler::start(const std::string &name) {
+        rootName = name;
+        stack.clear();
+        stack.push_back(Frame(&root, Clock::now()));
+    }
+
+    void Profiler::stop() {
+        if (stack.empty()) {
+            return;
+        }
+        // frames left open by an error end here as well
+        while (stack.size() > 1) {
+            onExit(stack.back().node->stmt);
+        }
+
+        auto &frame = stack.back();
+        std::chrono::duration<double> elapsed = Clock::now() - frame.start;
+        root.self += elapsed.count() - frame.children;
+        stack.clear();
+    }
+
+    void Profiler::onEnter(Stmt *stmt) {
+        if (stack.empty()) {
+            start("");
+        }
+
+        auto &children = stack.back().node->children;
+        auto it = children.find(stmt);
+        if (it == children.end()) {
+            it = children.insert(std::make_pair(stmt, std::make_unique<Node>(stmt))).first;
+        }
+
+        active[stmt]++;
+        stack.push_back(Frame(it->second.get(), Clock::now()));
+    }
+
+    void Profiler::onExit(Stmt *stmt) {
+        if (stack.size() < 2) {
+            return;
+        }
+
+        auto frame = stack.back();
+        stack.pop_back();
+        std::chrono::duration<double> elapsed = Clock::now() - frame.start;
+        double inclusive = elapsed.count();
+        double exclusive = inclusive - frame.children;
+        frame.node->self += exclusive;
+        stack.back().children += inclusive;
+
+        auto &entry = entries[frame.node->stmt];
+        entry.calls++;
+        entry.exclusive += exclusive;
+        if (--active[frame.node->stmt] == 0) {
+            entry.inclusive += inclusive;
+        }
+    }
+
+    std::vector<Profiler::Entry> Profiler::getEntries() {
+        std::vector<Entry> result;
+        for (auto &it : entries) {
+            result.push_back(it.second);
+            result.back().name = nameOf(it.first);
+        }
+        std::stable_sort(result.begin(), result.end(), [](const Entry &a, const Entry &b) {
+            return a.exclusive > b.exclusive;
+        });
+        return result;
+    }
+
+    void Profiler::writeCollapsed(std::ostream &stream) {
+        writeCollapsed(stream, &root, rootName);
+    }
+
+    void Profiler::writeCollapsed(std::ostream &stream, Node *node, const std::string &path) {
+        auto micros = (unsigned long)(node->self * 1000000);
+        if (micros > 0 && path != "") {
+            stream << path << " " << micros << std::endl;
+        }
+
+        for (auto &child : node->children) {
+            auto name = nameOf(child.first);
+            // ; separates frames
+            std::replace(name.begin(), name.end(), ';', ',');
+            writeCollapsed(stream, child.second.get(), path == "" ? name : path + ";" + name);
+        }
+    }
+
+    std::string Profiler::nameOf(Stmt *stmt) {
+        switch (stmt->getType()) {
+            case FUNCTION_STMT:
+                return "fn " + static_cast<FunctionStmt*>(stmt)->name->getLexeme();
+            case WHILE_STMT: {
+                auto keyword = static_cast<WhileStmt*>(stmt)->keyword;
+                if (!keyword.get()) {
+                    return "while";
+                }
+                return keyword->getLexeme() + " " + keyword->getPath() + ":" + std::to_string(keyword->getLine());
+            }
+            case FOR_IN_STMT: {
+                auto name = static_cast<ForInStmt*>(stmt)->name;
+                return "for " + name->getLexeme() + " " + name->getPath() + ":" + std::to_string(name->getLine());
+            }
+            case INCLUDE_STMT:
+                return "include " + static_cast<IncludeStmt*>(stmt)->path;
+            default:
+                return "?";
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <map>
+#include <string>
+#include <chrono>
+#include "interpreter.h"
+
+namespace lasm {
+    /**
+     * Measures the time spent in functions, loops and includes.
+     * Every call is timed, so the results are exact but the assembly gets slower
+     */
+    class Profiler: public InterpreterCallback {
+        public:
+            /**
+             * Totals of one function, loop or include
+             */
+            class Entry {
+                public:
+                    std::string name;
+                    unsigned long calls = 0;
+                    // seconds. inclusive time counts recursive calls once
+                    double inclusive = 0;
+                    double exclusive = 0;
+            };
+
+            /**
+             * A path through the call tree
+             */
+            class Node {
+                public:
+                    Node(Stmt *stmt):
+                        stmt(stmt) {}
+
+                    Stmt *stmt;
+                    // exclusive seconds
+                    double self = 0;
+                    std::map<Stmt*, std::unique_ptr<Node>> children;
+            };
+
+            Profiler();
+
+            /**
+             * Times everything up to stop as the root frame
+             */
+            void start(const std::string &name);
+            void stop();
+
+            virtual void onEnter(Stmt *stmt);
+            virtual void onExit(Stmt *stmt);
+
+            /**
+             * Entries by exclusive time, the slowest first
+             */
+            std::vector<Entry> getEntries();
+
+            /**
+             * Writes one line per call path. Frames are separated by ;
+             * and followed by the exclusive time in microseconds
+             */
+            void writeCollapsed(std::ostream &stream);
+
+            static std::string nameOf(Stmt *stmt);
+        private:
+            typedef std::chrono::steady_clock Clock;
+
+            void writeCollapsed(std::ostream &stream, Node *node, const std::string &path);
+
+            class Frame {
+                public:
+                    Frame(Node *node, Clock::time_point start):
+                        node(node), start(start) {}
+
+                    Node *node;
+                    Clock::time_point start;
+                    // inclusive seconds of the frames called from this one
+                    double children = 0;
+            };
+
+            std::string rootName;
+            Node root;
+            std::vector<Frame> stack;
+
+            std::map<Stmt*, Entry> entries;
+            // frames of a statement on the stack. only the outermost adds inclusive time
+            std::map<Stmt*, unsigned long> active;
+    };
+}
+
+#endif
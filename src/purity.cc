@@ -0,0 +1,265 @@
+#include "purity.h"
+#include "interpreter.h"
+#include "callable.h"
+
+namespace lasm {
+    bool PurityAnalyzer::isPure(FunctionStmt *stmt) {
+        function = stmt;
+        pure = true;
+        locals.clear();
+
+        locals.push_back(std::set<std::string>());
+        for (auto &param : stmt->params) {
+            locals.back().insert(param->getLexeme());
+        }
+        analyze(stmt->getBody());
+        locals.clear();
+
+        return pure;
+    }
+
+    bool PurityAnalyzer::emitsCode(FunctionStmt *stmt) {
+        function = stmt;
+        pure = true;
+        emission = true;
+        checked.clear();
+        checked.insert(stmt);
+        locals.clear();
+
+        locals.push_back(std::set<std::string>());
+        analyze(stmt->getBody());
+        locals.clear();
+        emission = false;
+
+        return !pure;
+    }
+
+    bool PurityAnalyzer::isInvariant(const std::shared_ptr<Expr> &expr) {
+        function = nullptr;
+        pure = true;
+        invariant = true;
+        locals.clear();
+
+        analyze(expr);
+        invariant = false;
+
+        return pure;
+    }
+
+    void PurityAnalyzer::analyze(const std::shared_ptr<Stmt> &stmt) {
+        if (!pure || !stmt.get()) {
+            return;
+        }
+        known = false;
+        stmt->accept(this);
+        pure = pure && known;
+    }
+
+    void PurityAnalyzer::analyze(const std::vector<std::shared_ptr<Stmt>> &stmts) {
+        for (auto &stmt : stmts) {
+            analyze(stmt);
+        }
+    }
+
+    void PurityAnalyzer::analyze(const std::shared_ptr<Expr> &expr) {
+        if (!pure || !expr.get()) {
+            return;
+        }
+        known = false;
+        expr->accept(this);
+        pure = pure && known;
+    }
+
+    bool PurityAnalyzer::isLocal(const std::string &name) {
+        for (auto &scope : locals) {
+            if (scope.find(name) != scope.end()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool PurityAnalyzer::isPureCallee(std::shared_ptr<Token> name) {
+        std::shared_ptr<LasmObject> callee;
+        try {
+            callee = interpreter->getEnv()->get(name);
+        } catch (LasmUndefinedReference &e) {
+            return false;
+        }
+
+        if (!callee->isCallable()) {
+            return false;
+        }
+
+        // plain recursion does not change anything
+        auto lasmFunction = dynamic_cast<LasmFunction*>(callee->toCallable().get());
+        if (lasmFunction && lasmFunction->getStmt() == function) {
+            return true;
+        }
+        return callee->toCallable()->isPure(interpreter);
+    }
+
+    FunctionStmt* PurityAnalyzer::findFunction(std::shared_ptr<Token> name) {
+        std::shared_ptr<LasmObject> callee;
+        try {
+            callee = interpreter->getEnv()->get(name);
+        } catch (LasmUndefinedReference &e) {
+            return nullptr;
+        }
+
+        if (!callee->isCallable()) {
+            return nullptr;
+        }
+        auto lasmFunction = dynamic_cast<LasmFunction*>(callee->toCallable().get());
+        return lasmFunction ? lasmFunction->getStmt() : nullptr;
+    }
+
+    std::any PurityAnalyzer::visitBinary(BinaryExpr *expr) {
+        analyze(expr->left);
+        analyze(expr->right);
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitUnary(UnaryExpr *expr) {
+        analyze(expr->right);
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitLiteral(LiteralExpr *expr) {
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitGrouping(GroupingExpr *expr) {
+        analyze(expr->expression);
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitVariable(VariableExpr *expr) {
+        // outer variables and labels may change between calls
+        auto &name = expr->name->getLexeme();
+        if (emission) {
+            known = true;
+            return std::any();
+        } else if (invariant) {
+            auto &values = interpreter->getGlobals()->getValues();
+            pure = pure && values.find(name) != values.end();
+        } else {
+            pure = pure && isLocal(name);
+        }
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitAssign(AssignExpr *expr) {
+        pure = pure && (emission || isLocal(expr->name->getLexeme()));
+        analyze(expr->value);
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitLogical(LogicalExpr *expr) {
+        analyze(expr->left);
+        analyze(expr->right);
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitCall(CallExpr *expr) {
+        // only named callees are known
+        auto callee = dynamic_cast<VariableExpr*>(expr->callee.get());
+        if (emission) {
+            // natives and callees that are not known by name never emit
+            auto stmt = callee ? findFunction(callee->name) : nullptr;
+            if (stmt && checked.insert(stmt).second) {
+                analyze(stmt->getBody());
+            }
+        } else if (!callee || isLocal(callee->name->getLexeme()) || !isPureCallee(callee->name)) {
+            pure = false;
+        }
+
+        for (auto &argument : expr->arguments) {
+            analyze(argument);
+        }
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitList(ListExpr *expr) {
+        for (auto &value : expr->list) {
+            analyze(value);
+        }
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitIndex(IndexExpr *expr) {
+        analyze(expr->object);
+        analyze(expr->index);
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitIndexAssign(IndexAssignExpr *expr) {
+        pure = pure && emission;
+        analyze(expr->object);
+        analyze(expr->index);
+        analyze(expr->value);
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitExpression(ExpressionStmt *stmt) {
+        analyze(stmt->expr);
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitLet(LetStmt *stmt) {
+        analyze(stmt->init);
+        locals.back().insert(stmt->name->getLexeme());
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitBlock(BlockStmt *stmt) {
+        locals.push_back(std::set<std::string>());
+        analyze(stmt->statements);
+        locals.pop_back();
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitIf(IfStmt *stmt) {
+        analyze(stmt->condition);
+        analyze(stmt->thenBranch);
+        analyze(stmt->elseBranch);
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitWhile(WhileStmt *stmt) {
+        analyze(stmt->condition);
+        analyze(stmt->body);
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitForIn(ForInStmt *stmt) {
+        analyze(stmt->iterable);
+        locals.push_back(std::set<std::string> {stmt->name->getLexeme()});
+        analyze(stmt->body);
+        locals.pop_back();
+        known = true;
+        return std::any();
+    }
+
+    std::any PurityAnalyzer::visitReturn(ReturnStmt *stmt) {
+        analyze(stmt->value);
+        known = true;
+        return std::any();
+    }
+}
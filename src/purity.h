@@ -0,0 +1,93 @@
+#ifndef __PURITY_H__
+#define __PURITY_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <set>
+#include "expr.h"
+#include "stmt.h"
+
+namespace lasm {
+    class Interpreter;
+
+    /**
+     * Decides if a function only depends on its arguments.
+     * A pure function does not emit code, define labels or move the address,
+     * does not assign or read variables outside of itself
+     * and only calls pure functions.
+     * Anything the analyzer does not know is impure,
+     * including index assignments since they may change an argument.
+     */
+    class PurityAnalyzer: public ExprVisitor, public StmtVisitor {
+        public:
+            PurityAnalyzer(Interpreter *interpreter):
+                interpreter(interpreter) {}
+
+            bool isPure(FunctionStmt *stmt);
+
+            /**
+             * Decides if a function may emit code, define labels or move the address,
+             * either in its own body or in a function it calls by name.
+             * Used to check functions that were declared pure
+             */
+            bool emitsCode(FunctionStmt *stmt);
+
+            /**
+             * Decides if a top level expression evaluates to the same value in every pass.
+             * It may read global variables, but not labels or the address
+             */
+            bool isInvariant(const std::shared_ptr<Expr> &expr);
+
+            std::any visitBinary(BinaryExpr *expr);
+            std::any visitUnary(UnaryExpr *expr);
+            std::any visitLiteral(LiteralExpr *expr);
+            std::any visitGrouping(GroupingExpr *expr);
+            std::any visitVariable(VariableExpr *expr);
+            std::any visitAssign(AssignExpr *expr);
+            std::any visitLogical(LogicalExpr *expr);
+            std::any visitCall(CallExpr *expr);
+            std::any visitList(ListExpr *expr);
+            std::any visitIndex(IndexExpr *expr);
+            std::any visitIndexAssign(IndexAssignExpr *expr);
+
+            std::any visitExpression(ExpressionStmt *stmt);
+            std::any visitLet(LetStmt *stmt);
+            std::any visitBlock(BlockStmt *stmt);
+            std::any visitIf(IfStmt *stmt);
+            std::any visitWhile(WhileStmt *stmt);
+            std::any visitForIn(ForInStmt *stmt);
+            std::any visitReturn(ReturnStmt *stmt);
+        private:
+            void analyze(const std::shared_ptr<Stmt> &stmt);
+            void analyze(const std::vector<std::shared_ptr<Stmt>> &stmts);
+            void analyze(const std::shared_ptr<Expr> &expr);
+
+            bool isLocal(const std::string &name);
+            bool isPureCallee(std::shared_ptr<Token> name);
+
+            /**
+             * The lasm function bound to name or nullptr
+             */
+            FunctionStmt* findFunction(std::shared_ptr<Token> name);
+
+            Interpreter *interpreter;
+            FunctionStmt *function = nullptr;
+
+            // names declared by the function, innermost block last
+            std::vector<std::set<std::string>> locals;
+
+            bool pure = true;
+            // global reads are allowed
+            bool invariant = false;
+            // only code, labels and the address matter.
+            // pure is cleared once anything may emit
+            bool emission = false;
+            // functions whose bodies were already checked for emission
+            std::set<FunctionStmt*> checked;
+            // set by every visit that is understood
+            bool known = false;
+    };
+}
+
+#endif
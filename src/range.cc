@@ -0,0 +1,37 @@
+#include "range.h"
+#include "list.h"
+
+namespace lasm {
+    unsigned long LasmRange::size() {
+        if (list.get()) {
+            return list->size();
+        }
+        return length;
+    }
+
+    LasmObject LasmRange::at(unsigned long index) {
+        if (list.get()) {
+            return list->at(index);
+        }
+        return LasmObject(NUMBER_O, start + (lasmNumber)index * step);
+    }
+
+    std::shared_ptr<LasmList> LasmRange::toList() {
+        if (!list.get()) {
+            std::vector<LasmObject> values;
+            values.reserve(length);
+            for (unsigned long i = 0; i < length; i++) {
+                values.push_back(LasmObject(NUMBER_O, start + (lasmNumber)i * step));
+            }
+            list = std::make_shared<LasmList>(std::move(values));
+        }
+        return list;
+    }
+
+    unsigned long LasmRange::count(lasmNumber start, lasmNumber end, lasmNumber step) {
+        if ((step > 0 && end > start) || (step < 0 && end < start)) {
+            return (end - start + step + (step > 0 ? -1 : 1)) / step;
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef __RANGE_H__
+#define __RANGE_H__
+
+#include <iostream>
+#include <memory>
+#include "object.h"
+
+namespace lasm {
+    class LasmList;
+
+    /**
+     * Value of a range object.
+     * Elements are computed when they are read. A range that is used as a list,
+     * for example by assigning to an element, becomes that list
+     */
+    class LasmRange {
+        public:
+            LasmRange(lasmNumber start, lasmNumber step, unsigned long length):
+                start(start), step(step), length(length) {}
+
+            unsigned long size();
+            LasmObject at(unsigned long index);
+
+            /**
+             * The elements as a list. Built on the first call
+             */
+            std::shared_ptr<LasmList> toList();
+
+            /**
+             * Number of elements from start up to but excluding end
+             */
+            static unsigned long count(lasmNumber start, lasmNumber end, lasmNumber step);
+
+            lasmNumber getStart() { return start; }
+            lasmNumber getStep() { return step; }
+            bool isList() { return list.get(); }
+        private:
+            lasmNumber start;
+            lasmNumber step;
+            unsigned long length;
+
+            std::shared_ptr<LasmList> list;
+    };
+}
+
+#endif
@@ -8,11 +8,14 @@ namespace lasm {
             addKeyword("false", FALSE);
             addKeyword("for", FOR);
             addKeyword("fn", FUNCTION);
+            addKeyword("pure", PURE);
             addKeyword("if", IF);
             addKeyword("nil", NIL);
             addKeyword("true", TRUE);
             addKeyword("let", LET);
+            addKeyword("const", CONST);
             addKeyword("while", WHILE);
+            addKeyword("in", IN);
             addKeyword("return", RETURN);
             addKeyword("org", ORG);
             addKeyword("fill", FILL);
@@ -0,0 +1,18 @@
+#include "stats.h"
+
+namespace lasm {
+    void Stats::reset() {
+        environmentGets = 0;
+        environmentHops = 0;
+        undefinedReferences = 0;
+        objectCopies = 0;
+        instructionResults = 0;
+        instructionBytes = 0;
+        loopIterations = 0;
+        calls.clear();
+    }
+
+    void Stats::call(const std::string &name) {
+        calls[name]++;
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef __STATS_H__
+#define __STATS_H__
+
+#include <iostream>
+#include <string>
+#include <map>
+#include "lasm_config.h"
+
+namespace lasm {
+    /**
+     * Counters of the interpreter's hot paths.
+     * They only count if lasm was configured with --enable-stats,
+     * otherwise every LASM_STAT macro compiles to nothing
+     */
+    class Stats {
+        public:
+            static void reset();
+
+            /**
+             * Counts a call of the function name
+             */
+            static void call(const std::string &name);
+
+            inline static unsigned long environmentGets = 0;
+            // parent environments visited by lookups
+            inline static unsigned long environmentHops = 0;
+            inline static unsigned long undefinedReferences = 0;
+            inline static unsigned long objectCopies = 0;
+            inline static unsigned long instructionResults = 0;
+            inline static unsigned long instructionBytes = 0;
+            inline static unsigned long loopIterations = 0;
+            // calls by function name
+            inline static std::map<std::string, unsigned long> calls;
+    };
+}
+
+#ifdef LASM_STATS
+#define LASM_STAT(counter) (lasm::Stats::counter++)
+#define LASM_STAT_ADD(counter, value) (lasm::Stats::counter += (value))
+#define LASM_STAT_CALL(name) (lasm::Stats::call(name))
+#else
+#define LASM_STAT(counter) ((void)0)
+#define LASM_STAT_ADD(counter, value) ((void)0)
+#define LASM_STAT_CALL(name) ((void)0)
+#endif
+
+#endif
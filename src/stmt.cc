@@ -21,10 +21,24 @@ namespace lasm {
         return visitor->visitWhile(this);
     }
 
+    std::any ForInStmt::accept(StmtVisitor *visitor) {
+        return visitor->visitForIn(this);
+    }
+
     std::any FunctionStmt::accept(StmtVisitor *visitor) {
         return visitor->visitFunction(this);
     }
 
+    std::vector<std::shared_ptr<Stmt>>& FunctionStmt::getBody() {
+        if (lazyBody.get()) {
+            // release the tokens even if parsing fails
+            auto lazy = lazyBody;
+            lazyBody.reset();
+            body = lazy->parse();
+        }
+        return body;
+    }
+
     std::any ReturnStmt::accept(StmtVisitor *visitor) {
         return visitor->visitReturn(this);
     }
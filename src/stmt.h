@@ -7,6 +7,8 @@
 #include "expr.h"
 #include "instruction.h"
 #include "environment.h"
+#include "memo.h"
+#include "lazybody.h"
 
 namespace lasm {
     enum StmtType {
@@ -15,6 +17,7 @@ namespace lasm {
         BLOCK_STMT,
         IF_STMT,
         WHILE_STMT,
+        FOR_IN_STMT,
         FUNCTION_STMT,
         RETURN_STMT,
         LABEL_STMT,
@@ -65,13 +68,14 @@ namespace lasm {
 
     class LetStmt: public Stmt {
         public:
-            LetStmt(std::shared_ptr<Token> name, std::shared_ptr<Expr> init):
-                Stmt::Stmt(LET_STMT), name(name), init(init) {}
+            LetStmt(std::shared_ptr<Token> name, std::shared_ptr<Expr> init, bool constant=false):
+                Stmt::Stmt(LET_STMT), name(name), init(init), constant(constant) {}
 
             virtual std::any accept(StmtVisitor *visitor);
 
             std::shared_ptr<Token> name;
             std::shared_ptr<Expr> init;
+            bool constant;
     };
 
     class BlockStmt: public Stmt {
@@ -100,26 +104,62 @@ namespace lasm {
 
     class WhileStmt: public Stmt {
         public:
-            WhileStmt(std::shared_ptr<Expr> condition, std::shared_ptr<Stmt> body):
-                Stmt::Stmt(WHILE_STMT), condition(condition), body(body) {}
+            WhileStmt(std::shared_ptr<Expr> condition, std::shared_ptr<Stmt> body,
+                    std::shared_ptr<Token> keyword=std::shared_ptr<Token>(nullptr)):
+                Stmt::Stmt(WHILE_STMT), condition(condition), body(body), keyword(keyword) {}
 
             virtual std::any accept(StmtVisitor *visitor);
 
             std::shared_ptr<Expr> condition;
             std::shared_ptr<Stmt> body;
+            // while or for
+            std::shared_ptr<Token> keyword;
+    };
+
+    /**
+     * for (name in iterable) body
+     */
+    class ForInStmt: public Stmt {
+        public:
+            ForInStmt(std::shared_ptr<Token> name, std::shared_ptr<Expr> iterable, std::shared_ptr<Stmt> body):
+                Stmt::Stmt(FOR_IN_STMT), name(name), iterable(iterable), body(body) {}
+
+            virtual std::any accept(StmtVisitor *visitor);
+
+            std::shared_ptr<Token> name;
+            std::shared_ptr<Expr> iterable;
+            std::shared_ptr<Stmt> body;
     };
 
     class FunctionStmt: public Stmt {
         public:
             FunctionStmt(std::shared_ptr<Token> name, std::vector<std::shared_ptr<Token>> params,
-                    std::vector<std::shared_ptr<Stmt>> body):
-                Stmt::Stmt(FUNCTION_STMT), name(name), params(params), body(body) {}
+                    std::vector<std::shared_ptr<Stmt>> body, bool pure=false):
+                Stmt::Stmt(FUNCTION_STMT), name(name), params(params), body(body), pure(pure) {}
 
             virtual std::any accept(StmtVisitor *visitor);
 
+            /**
+             * The statements of the body. Parses a lazy body on the first access
+             */
+            std::vector<std::shared_ptr<Stmt>>& getBody();
+
             std::shared_ptr<Token> name;
             std::vector<std::shared_ptr<Token>> params;
             std::vector<std::shared_ptr<Stmt>> body;
+
+            // set until the body is parsed
+            std::shared_ptr<LazyBody> lazyBody;
+
+            // declared with pure fn
+            bool pure;
+
+            // result of the purity analysis and the pass it was made in
+            long analyzedPass = -1;
+            bool analyzedPure = false;
+
+            // results of pure calls. kept for all passes
+            MemoTable memo;
     };
 
     class ReturnStmt: public Stmt {
@@ -219,6 +259,11 @@ namespace lasm {
             std::vector<std::shared_ptr<Expr>> values;
             unsigned int size;
             Endianess endianess;
+
+            // statements made only of number literals are encoded by the parser.
+            // values is empty if packed is set
+            std::shared_ptr<char[]> packed;
+            unsigned long packedSize = 0;
     };
 
     class BssStmt: public Stmt {
@@ -261,6 +306,8 @@ namespace lasm {
 
             std::vector<std::shared_ptr<Stmt>> stmts;
             bool wasparsed = false; // set to true to not re-parse
+            // file the statements were read from
+            std::string path;
     };
 
     class StmtVisitor {
@@ -272,6 +319,7 @@ namespace lasm {
             virtual std::any visitBlock(BlockStmt *stmt) { return std::any(nullptr); };
             virtual std::any visitIf(IfStmt *stmt) { return std::any(nullptr); };
             virtual std::any visitWhile(WhileStmt *stmt) { return std::any(nullptr); };
+            virtual std::any visitForIn(ForInStmt *stmt) { return std::any(nullptr); };
             virtual std::any visitFunction(FunctionStmt *stmt) { return std::any(nullptr); };
             virtual std::any visitReturn(ReturnStmt *stmt) { return std::any(nullptr); };
             virtual std::any visitLabel(LabelStmt *stmt) { return std::any(nullptr); };
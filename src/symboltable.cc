@@ -0,0 +1,69 @@
+#include "symboltable.h"
+#include <algorithm>
+
+namespace lasm {
+    void SymbolTable::clear() {
+        scopes.clear();
+        symbols.clear();
+        sorted = true;
+    }
+
+    void SymbolTable::compact(std::shared_ptr<Environment> env) {
+        if (!env->getParent().get()) {
+            return;
+        }
+
+        // the scope may already exist if a nested scope was compacted first.
+        // the name could have changed since then
+        if (env->getSymbolScope() != -1) {
+            scopes[env->getSymbolScope()].name = env->getName();
+        }
+
+        // empty scopes are dropped
+        auto &values = env->getValues();
+        if (values.empty()) {
+            return;
+        }
+
+        long scope = intern(env.get());
+        for (auto it = values.begin(); it != values.end(); it++) {
+            symbols.push_back(Symbol(it->first, *it->second, scope));
+        }
+        sorted = false;
+    }
+
+    long SymbolTable::intern(Environment *env) {
+        if (!env->getParent().get()) {
+            return -1;
+        }
+
+        if (env->getSymbolScope() == -1) {
+            long parent = intern(env->getParent().get());
+            env->setSymbolScope(scopes.size());
+            scopes.push_back(SymbolScope(env->getName(), parent, env->getScopeOrder()));
+        }
+        return env->getSymbolScope();
+    }
+
+    std::vector<Symbol>& SymbolTable::getSymbols() {
+        if (!sorted) {
+            // symbols are added when a scope is left, but they are expected in the order
+            // the scopes were entered
+            std::stable_sort(symbols.begin(), symbols.end(), [this](const Symbol &a, const Symbol &b) {
+                return scopes[a.scope].order < scopes[b.scope].order;
+            });
+            sorted = true;
+        }
+        return symbols;
+    }
+
+    std::string SymbolTable::qualify(std::string name, long scope, std::string delim) {
+        while (scope != -1) {
+            if (scopes[scope].name != "") {
+                name = scopes[scope].name + delim + name;
+            }
+            scope = scopes[scope].parent;
+        }
+        return name;
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef __SYMBOLTABLE_H__
+#define __SYMBOLTABLE_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "object.h"
+#include "environment.h"
+
+namespace lasm {
+    /**
+     * A named label scope inside the symbol table.
+     * parent is the index of the enclosing scope or -1 for the global label scope
+     */
+    class SymbolScope {
+        public:
+            SymbolScope(std::string name, long parent, unsigned long order):
+                name(name), parent(parent), order(order) {}
+
+            std::string name;
+            long parent;
+            unsigned long order;
+    };
+
+    class Symbol {
+        public:
+            Symbol(std::string name, LasmObject value, long scope):
+                name(name), value(value), scope(scope) {}
+
+            std::string name;
+            LasmObject value;
+            long scope;
+    };
+
+    /**
+     * Flat arena of all labels defined during a pass.
+     * Label environments are compacted into this table as soon as their block is left.
+     * Scopes without labels are never stored, so the table grows
+     * with the amount of labels rather than the amount of executed blocks.
+     */
+    class SymbolTable {
+        public:
+            void clear();
+
+            /**
+             * Moves all labels of a label environment that is being left into the table.
+             * The global label environment (the one without a parent) is never compacted.
+             */
+            void compact(std::shared_ptr<Environment> env);
+
+            /**
+             * Returns all symbols in the order their scopes were entered
+             */
+            std::vector<Symbol>& getSymbols();
+
+            /**
+             * Prefixes name with all named scopes starting at scope
+             */
+            std::string qualify(std::string name, long scope, std::string delim);
+
+            std::vector<SymbolScope>& getScopes() { return scopes; }
+        private:
+            long intern(Environment *env);
+
+            std::vector<SymbolScope> scopes;
+            std::vector<Symbol> symbols;
+            bool sorted = true;
+    };
+}
+
+#endif
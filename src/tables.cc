@@ -0,0 +1,239 @@
+#include "tables.h"
+#include "interpreter.h"
+#include "list.h"
+#include "range.h"
+#include "bytearray.h"
+#include <cmath>
+#include <algorithm>
+
+// largest table a generator builds
+#define TABLE_MAX_LENGTH 0x1000000
+
+namespace lasm {
+    static lasmNumber numberArgument(Arguments arguments, unsigned long index, CallExpr *expr,
+            lasmNumber fallback=0) {
+        if (index >= arguments.size()) {
+            return fallback;
+        }
+
+        auto &value = arguments[index];
+        if (!value.isNumber()) {
+            throw LasmTypeError(std::vector<ObjectType> {NUMBER_O}, value.getType(), expr->paren);
+        }
+        return value.toNumber();
+    }
+
+    static lasmReal realArgument(Arguments arguments, unsigned long index, CallExpr *expr,
+            lasmReal fallback=0) {
+        if (index >= arguments.size()) {
+            return fallback;
+        }
+
+        auto &value = arguments[index];
+        if (value.isNumber()) {
+            return value.toNumber();
+        } else if (!value.isReal()) {
+            throw LasmTypeError(std::vector<ObjectType> {NUMBER_O, REAL_O}, value.getType(), expr->paren);
+        }
+        return value.toReal();
+    }
+
+    static lasmNumber lengthArgument(Arguments arguments, unsigned long index, CallExpr *expr) {
+        auto length = numberArgument(arguments, index, expr);
+        if (length < 0 || length > TABLE_MAX_LENGTH) {
+            throw LasmException(VALUE_OUT_OF_RANGE, expr->paren);
+        }
+        return length;
+    }
+
+    /**
+     * Packs values into an array of the smallest width that holds all of them,
+     * but at least minWidth bytes. Arrays are unsigned, so tables with
+     * negative or wider values are lists
+     */
+    static LasmObject makeTable(std::vector<lasmNumber> &values, unsigned short minWidth=1) {
+        lasmNumber max = 0;
+        bool negative = false;
+        for (auto value : values) {
+            max = std::max(max, value);
+            negative = negative || value < 0;
+        }
+
+        unsigned short width = minWidth;
+        while (width < 4 && max >> (width * 8)) {
+            width *= 2;
+        }
+
+        if (negative || max >> (width * 8)) {
+            std::vector<LasmObject> objects;
+            objects.reserve(values.size());
+            for (auto value : values) {
+                objects.push_back(LasmObject(NUMBER_O, value));
+            }
+            return LasmObject(LIST_O, std::make_shared<LasmList>(std::move(objects)));
+        }
+
+        auto array = std::make_shared<ByteArray>(width, values.size());
+        for (unsigned long i = 0; i < values.size(); i++) {
+            array->set(i, values[i]);
+        }
+        return LasmObject(BYTES_O, array);
+    }
+
+    static LasmObject waveTable(Arguments arguments, CallExpr *expr, lasmReal shift) {
+        auto length = lengthArgument(arguments, 0, expr);
+        auto amplitude = realArgument(arguments, 1, expr);
+        auto phase = realArgument(arguments, 2, expr);
+        auto offset = realArgument(arguments, 3, expr);
+
+        std::vector<lasmNumber> values;
+        values.reserve(length);
+        for (lasmNumber i = 0; i < length; i++) {
+            lasmReal angle = 2 * M_PI * (i + phase) / length + shift;
+            values.push_back(lasmNumber(std::lround(offset + amplitude * std::sin(angle))));
+        }
+        return makeTable(values);
+    }
+
+    LasmObject NativeSinTable::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        return waveTable(arguments, expr, 0);
+    }
+
+    LasmObject NativeCosTable::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        return waveTable(arguments, expr, M_PI / 2);
+    }
+
+    LasmObject NativePopcountTable::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto length = lengthArgument(arguments, 0, expr);
+
+        std::vector<lasmNumber> values;
+        values.reserve(length);
+        for (lasmNumber i = 0; i < length; i++) {
+            lasmNumber count = 0;
+            for (unsigned long bits = i; bits; bits &= bits - 1) {
+                count++;
+            }
+            values.push_back(count);
+        }
+        return makeTable(values);
+    }
+
+    LasmObject NativeBitrevTable::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto length = lengthArgument(arguments, 0, expr);
+        auto bits = numberArgument(arguments, 1, expr, 8);
+        if (bits < 0 || bits > 32) {
+            throw LasmException(VALUE_OUT_OF_RANGE, expr->paren);
+        }
+
+        std::vector<lasmNumber> values;
+        values.reserve(length);
+        for (lasmNumber i = 0; i < length; i++) {
+            lasmNumber reversed = 0;
+            for (lasmNumber bit = 0; bit < bits; bit++) {
+                reversed = (reversed << 1) | ((i >> bit) & 1);
+            }
+            values.push_back(reversed);
+        }
+        return makeTable(values);
+    }
+
+    LasmObject NativeQuarterSquareTable::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto length = lengthArgument(arguments, 0, expr);
+
+        // a * b = qsquare(a + b) - qsquare(a - b)
+        std::vector<lasmNumber> values;
+        values.reserve(length);
+        for (lasmNumber i = 0; i < length; i++) {
+            values.push_back(lasmNumber(i * i / 4));
+        }
+        return makeTable(values);
+    }
+
+    LasmObject NativeRecipTable::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto length = lengthArgument(arguments, 0, expr);
+        auto scale = numberArgument(arguments, 1, expr);
+
+        // there is no reciprocal of 0, it is stored as 0
+        std::vector<lasmNumber> values;
+        values.reserve(length);
+        for (lasmNumber i = 0; i < length; i++) {
+            values.push_back(lasmNumber(i ? scale / i : 0));
+        }
+        return makeTable(values);
+    }
+
+    LasmObject NativeCrc16Table::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        // CRC-16/CCITT, most significant bit first
+        auto polynomial = numberArgument(arguments, 0, expr, 0x1021);
+
+        std::vector<lasmNumber> values;
+        values.reserve(256);
+        for (lasmNumber i = 0; i < 256; i++) {
+            unsigned long crc = i << 8;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x8000) ? (crc << 1) ^ polynomial : crc << 1;
+            }
+            values.push_back(lasmNumber(crc & 0xFFFF));
+        }
+        return makeTable(values, 2);
+    }
+
+    LasmObject NativeCrc32Table::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        // CRC-32, least significant bit first
+        auto polynomial = numberArgument(arguments, 0, expr, 0xEDB88320);
+
+        std::vector<lasmNumber> values;
+        values.reserve(256);
+        for (lasmNumber i = 0; i < 256; i++) {
+            unsigned long crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? (crc >> 1) ^ polynomial : crc >> 1;
+            }
+            values.push_back(lasmNumber(crc & 0xFFFFFFFF));
+        }
+        return makeTable(values, 4);
+    }
+
+    LasmObject NativeFixed::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto value = realArgument(arguments, 0, expr);
+        auto bits = numberArgument(arguments, 1, expr);
+        if (bits < 0 || bits > 62) {
+            throw LasmException(VALUE_OUT_OF_RANGE, expr->paren);
+        }
+        return LasmObject(NUMBER_O, lasmNumber(std::llround(std::ldexp(value, bits))));
+    }
+
+    LasmObject NativeFixMul::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        auto a = numberArgument(arguments, 0, expr);
+        auto b = numberArgument(arguments, 1, expr);
+        auto bits = numberArgument(arguments, 2, expr);
+        if (bits < 0 || bits > 62) {
+            throw LasmException(VALUE_OUT_OF_RANGE, expr->paren);
+        }
+        return LasmObject(NUMBER_O, lasmNumber((a * b) >> bits));
+    }
+
+    LasmObject NativeRange::call(Interpreter *interpreter, Arguments arguments, CallExpr *expr) {
+        lasmNumber start = 0;
+        lasmNumber end = 0;
+        if (arguments.size() == 1) {
+            end = numberArgument(arguments, 0, expr);
+        } else {
+            start = numberArgument(arguments, 0, expr);
+            end = numberArgument(arguments, 1, expr);
+        }
+        auto step = numberArgument(arguments, 2, expr, 1);
+
+        if (step == 0) {
+            throw LasmException(VALUE_OUT_OF_RANGE, expr->paren);
+        }
+
+        auto length = LasmRange::count(start, end, step);
+        if (length > TABLE_MAX_LENGTH) {
+            throw LasmException(VALUE_OUT_OF_RANGE, expr->paren);
+        }
+
+        // elements are only computed when they are read
+        return LasmObject(RANGE_O, std::make_shared<LasmRange>(start, step, length));
+    }
+}
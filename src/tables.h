@@ -0,0 +1,138 @@
+#ifndef __TABLES_H__
+#define __TABLES_H__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "callable.h"
+
+namespace lasm {
+    /**
+     * Native table generators.
+     * Tables are packed arrays that db, dh, dw and dd emit as one block.
+     * Tables with negative entries are lists
+     */
+
+    // sintable(length, amplitude[, phase[, offset]])
+    class NativeSinTable: public Callable {
+        public:
+            NativeSinTable():
+                Callable::Callable(2, 4) {}
+            ~NativeSinTable() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    // costable(length, amplitude[, phase[, offset]])
+    class NativeCosTable: public Callable {
+        public:
+            NativeCosTable():
+                Callable::Callable(2, 4) {}
+            ~NativeCosTable() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    // popcounttable(length)
+    class NativePopcountTable: public Callable {
+        public:
+            NativePopcountTable():
+                Callable::Callable(1) {}
+            ~NativePopcountTable() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    // bitrevtable(length[, bits])
+    class NativeBitrevTable: public Callable {
+        public:
+            NativeBitrevTable():
+                Callable::Callable(1, 2) {}
+            ~NativeBitrevTable() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    // qsquaretable(length)
+    class NativeQuarterSquareTable: public Callable {
+        public:
+            NativeQuarterSquareTable():
+                Callable::Callable(1) {}
+            ~NativeQuarterSquareTable() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    // reciptable(length, scale)
+    class NativeRecipTable: public Callable {
+        public:
+            NativeRecipTable():
+                Callable::Callable(2) {}
+            ~NativeRecipTable() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    // crc16table([polynomial])
+    class NativeCrc16Table: public Callable {
+        public:
+            NativeCrc16Table():
+                Callable::Callable(0, 1) {}
+            ~NativeCrc16Table() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    // crc32table([polynomial])
+    class NativeCrc32Table: public Callable {
+        public:
+            NativeCrc32Table():
+                Callable::Callable(0, 1) {}
+            ~NativeCrc32Table() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    // fixed(value, fractionBits)
+    class NativeFixed: public Callable {
+        public:
+            NativeFixed():
+                Callable::Callable(2) {}
+            ~NativeFixed() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    // fixmul(a, b, fractionBits)
+    class NativeFixMul: public Callable {
+        public:
+            NativeFixMul():
+                Callable::Callable(3) {}
+            ~NativeFixMul() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+
+    // range(end) or range(start, end[, step])
+    class NativeRange: public Callable {
+        public:
+            NativeRange():
+                Callable::Callable(1, 3) {}
+            ~NativeRange() {}
+
+            virtual LasmObject call(Interpreter *interpreter, Arguments arguments, CallExpr *expr);
+            virtual bool isPure(Interpreter *interpreter) { return true; }
+    };
+}
+
+#endif
@@ -20,7 +20,7 @@ namespace lasm {
                 return type;
             }
 
-            std::string getLexeme() {
+            const std::string& getLexeme() {
                 return lexeme;
             }
 
@@ -27,7 +27,7 @@ namespace lasm {
 
         // keywords
         AND, ELSE, FALSE, FUNCTION, FOR, IF, NIL, OR,
-        RETURN, TRUE, LET, WHILE, IMPORT,
+        RETURN, TRUE, LET, WHILE, IMPORT, PURE, CONST, IN,
 
         // assembler
         INSTRUCTION, LABEL, DIRECTIVE,
@@ -1,5 +1,7 @@
 #include "utility.h"
 #include <sstream>
+#include <cstring>
+#include <algorithm>
 
 namespace lasm {
     char unescapeChar(std::string str, bool &didEscape, unsigned long index) {
@@ -53,4 +55,28 @@ namespace lasm {
 
         return strstream.str();
     }
+
+    Endianess getNativeByteOrder() {
+        // check endianess
+        const unsigned int x = 0x12345678;
+        if (*((char*)&x) == 0x78) {
+            // little endian
+            return LITTLE;
+        }
+        // big endian
+        return BIG;
+    }
+
+    void encodeNumber(char *out, long value, unsigned short size, Endianess endianess) {
+        char bytes[sizeof(long)];
+        memcpy(bytes, &value, sizeof(long));
+
+        // the lowest size bytes, like casting to a smaller type
+        const char *low = getNativeByteOrder() == LITTLE ? bytes : bytes + sizeof(long) - size;
+        if (endianess != getNativeByteOrder()) {
+            std::reverse_copy(low, low + size, out);
+        } else {
+            memcpy(out, low, size);
+        }
+    }
 }
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <cmath>
+#include "types.h"
 
 #define RDBYTE(n, pos, bits) ((n >> (bits * pos)) & ((unsigned int)std::pow(2, bits)-1))
 #define LO(n, bits) RDBYTE(n, 1, bits)
@@ -11,6 +12,14 @@
 namespace lasm {
     char unescapeChar(std::string str, bool &didEscape, unsigned long index=0);
     std::string unescape(std::string src);
+
+    Endianess getNativeByteOrder();
+
+    /**
+     * Writes value as a size byte number the way db, dh, dw and dd do:
+     * in native byte order, reversed if endianess is not the native byte order
+     */
+    void encodeNumber(char *out, long value, unsigned short size, Endianess endianess);
 }
 
 #endif
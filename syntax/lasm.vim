@@ -27,7 +27,7 @@ syn match asmLabel		"([a-z_][a-z0-9_]):"
 syn match asmComment		"\/\/.*"hs=s+1 contains=asmTodo
 syn keyword asmTodo	contained todo fixme xxx warning danger note notice bug
 syn region asmString		start=+"+ skip=+\\"+ end=+"+
-syn keyword asmSettings		define enum org include db dw incbin fn for while if let bss dh dd
+syn keyword asmSettings		define enum org include db dw incbin fn for in while if let bss dh dd pure const
 syn match asmSettings "^[.][a-z]*"
 
 syn match decNumber	"\<\d\+\>"
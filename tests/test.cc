@@ -8,6 +8,7 @@
 #include "test_interpreter.h"
 #include "test_environment.h"
 #include "test_frontend.h"
+#include "test_optimizer.h"
 
 #include <stdarg.h>
 #include <stddef.h>
@@ -53,10 +54,14 @@ extern "C" {
 
             // environment
             cmocka_unit_test(test_environment),
+            cmocka_unit_test(test_environment_reset),
 
             // frontend
             cmocka_unit_test(test_frontend),
-            cmocka_unit_test(test_frontend_errors)
+            cmocka_unit_test(test_frontend_errors),
+
+            // optimizer
+            cmocka_unit_test(test_optimizer)
         };
         return cmocka_run_group_tests(tests, NULL, NULL);
     }
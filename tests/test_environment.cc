@@ -22,3 +22,31 @@ void test_environment(void **state) {
         env.get(notFound);
     });
 }
+
+void test_environment_reset(void **state) {
+    auto parent = std::make_shared<Environment>(Environment());
+    Environment env;
+    LasmObject obj(NUMBER_O, lasmNumber(123));
+    env.define("test", obj);
+    auto held = env.getValues()["test"];
+
+    env.reset(parent);
+    assert_int_equal(env.getValues().size(), 0);
+    assert_ptr_equal(env.getParent().get(), parent.get());
+    // values that are still referenced are left alone
+    assert_int_equal(held->toNumber(), 123);
+
+    std::shared_ptr<Token> token = std::make_shared<Token>(Token(IDENTIFIER, "other",
+                LasmObject(NIL_O, nullptr), -1, "", 0, nullptr));
+    LasmObject other(NUMBER_O, lasmNumber(5));
+    env.define("other", other);
+    assert_int_equal(env.get(token)->toNumber(), 5);
+    assert_int_equal(held->toNumber(), 123);
+
+    // unused values are reused in place
+    auto ptr = env.get(token).get();
+    env.reset(parent);
+    env.define("other", obj);
+    assert_ptr_equal(env.get(token).get(), ptr);
+    assert_int_equal(env.get(token)->toNumber(), 123);
+}
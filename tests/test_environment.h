@@ -2,5 +2,6 @@
 #define __TEST_ENVIORMENT_H__
 
 void test_environment(void **state);
+void test_environment_reset(void **state);
 
 #endif 
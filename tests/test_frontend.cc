@@ -4,6 +4,8 @@
 #include "macros.h"
 #include "instruction6502.h"
 #include "instruction65816.h"
+#include "memtrack.h"
+#include <map>
 
 using namespace lasm;
 
@@ -29,14 +31,43 @@ class DummyWriter: public FileWriter {
         virtual std::shared_ptr<std::ostream> openFile(std::string fromPath) {
             if (fromPath == "test.lst") {
                 return list;
+            } else if (fromPath == "test.bin") {
+                return bin;
             }
 
-            return bin;
+            // reports
+            auto &file = files[fromPath];
+            if (!file.get()) {
+                file = std::make_shared<std::ostringstream>(std::ostringstream());
+            }
+            return file;
+        }
+
+        std::string read(const std::string &path) {
+            auto file = files.find(path);
+            return file == files.end() ? "" : file->second->str();
         }
+
         std::shared_ptr<std::ostringstream> list = std::make_shared<std::ostringstream>(std::ostringstream());
         std::shared_ptr<std::ostringstream> bin = std::make_shared<std::ostringstream>(std::ostringstream());
+    private:
+        std::map<std::string, std::shared_ptr<std::ostringstream>> files;
 };
 
+/**
+ * Assembles code and returns the report written to the path in field of settings
+ */
+static std::string test_report(std::string code, std::string FrontendSettings::*field,
+        FrontendSettings settings=FrontendSettings()) {
+    auto reader = DummyReader(code);
+    auto writer = DummyWriter();
+    InstructionSet6502 instructions;
+    settings.*field = "test.report";
+    Frontend frontend(instructions, reader, writer, settings);
+    assert_int_equal(frontend.assemble("test.asm", "test.bin", "test.lst"), 0);
+    return writer.read("test.report");
+}
+
 #define test_full(code, lst, is, ...) {\
     auto reader = DummyReader(code);\
     auto writer = DummyWriter();\
@@ -78,6 +109,19 @@ void test_frontend(void **state) {
             {(char)0xEA, (char)0xA9, (char)0xFF, (char)0xEA, (char)0xEA,
             'H', 'e', 'l', 'l', 'o', (char)0xEA, 'a', 0x05, 0x03});
 
+    // binary files as arrays
+    test_full("let data = readbin(\"inc.bin\"); db slice(data, 1, 2), len(data);",
+            "",
+            InstructionSet6502,
+            {'e', 'l', 0x05});
+
+    // functions declared pure still emit their code in every pass
+    test_full("pure fn e(x) { nop; return x; } fn g(x) { lda #x; } pure fn h(x) { g(x); return x; }"
+            "db e(1); db e(1); db h(2);",
+            "",
+            InstructionSet6502,
+            {(char)0xEA, 0x01, (char)0xEA, 0x01, (char)0xA9, 0x02, 0x02});
+
     // test label names
     test_full("org 0x8000;\n"
             "scope1: {\n"
@@ -88,6 +132,19 @@ void test_frontend(void **state) {
             InstructionSet6502,
             {(char)0xEA});
 
+    // empty scopes are dropped, names given after a nested scope was left still apply
+    test_full("org 0x8000;\n"
+            "outer: {\n"
+                "inner: { deep: nop; }\n"
+                "{ }\n"
+                "for (let i = 0; i < 2; i = i + 1) { }\n"
+                "setScopeName(\"late\");\n"
+                "after: nop;\n"
+            "}",
+            "outer = 0x8000\nlate.after = 0x8001\nlate.inner = 0x8000\nlate.deep = 0x8000\n",
+            InstructionSet6502,
+            {(char)0xEA, (char)0xEA});
+
     // test 65816 immediate16, long and long, x
     // sr, src,x block move
     test_full("m16; adc #0xFFFF;\n"
@@ -134,6 +191,92 @@ void test_frontend(void **state) {
             (char)0x6D, 0x1A, 0x00,
             (char)0x6F, 0x1A, 0x00, 0x00});
 
+    // cache statistics
+    auto stats = test_report("let a = 2; nop; lda #lo(a * 0x100 + 3);", &FrontendSettings::statsPath);
+    std::string expected =
+                "expression_cache_hits = 1\n"
+                "expression_cache_misses = 1\n"
+                "expression_cache_entries = 1\n"
+                "memo_hits = 0\n"
+                "memo_misses = 0\n";
+#ifdef LASM_STATS
+    assert_cc_string_equal(stats.substr(0, expected.length()), expected);
+
+    // hot path counters. the second pass answers the pure calls from the memo table
+    stats = test_report("fn f(x) { return x; } let i = 0; while (i < 3) { i = f(i) + 1; } db i;",
+            &FrontendSettings::statsPath);
+    assert_true(stats.find("\nloop_iterations = 6\n") != std::string::npos);
+    assert_true(stats.find("\ncalls.f = 3\n") != std::string::npos);
+    assert_true(stats.find("\ninstruction_results = 2\n") != std::string::npos);
+    assert_true(stats.find("\ninstruction_bytes = 2\n") != std::string::npos);
+    assert_true(stats.find("\nundefined_references = 0\n") != std::string::npos);
+#else
+    assert_cc_string_equal(stats, expected);
+#endif
+
+    // profile
+    std::string profiled = "fn f(x) { return x + 1; }\n"
+            "fn g() { let j = 0; while (j < 2000) { j = j + 1; } return j; }\n"
+            "let i = 0; while (i < 3) { i = f(i); }\n"
+            "db g(); include \"inc.asm\"";
+    auto profile = test_report(profiled, &FrontendSettings::profilePath);
+    assert_int_equal(profile.find(" exclusive (s) inclusive (s)     calls  name\n"), 0);
+    // pure calls are only run in the first pass
+    assert_true(profile.find("         3  fn f\n") != std::string::npos);
+    assert_true(profile.find("         1  fn g\n") != std::string::npos);
+    assert_true(profile.find("         2  while test.asm:3\n") != std::string::npos);
+    assert_true(profile.find("         2  include inc.asm\n") != std::string::npos);
+    assert_true(test_report(profiled, &FrontendSettings::flameGraphPath)
+            .find("test.asm;fn g;while test.asm:2 ") != std::string::npos);
+
+    // phase timings
+    auto time = test_report("nop; include \"inc.asm\"", &FrontendSettings::timingPath);
+    assert_int_equal(time.find("phase       file"), 0);
+    assert_true(time.find("\nparse       test.asm ") != std::string::npos);
+    assert_true(time.find("\nparse       inc.asm ") != std::string::npos);
+    assert_true(time.find("\npass 2 ") != std::string::npos);
+    assert_true(time.find("\nexecute     inc.asm ") != std::string::npos);
+    assert_true(time.find("\nwrite       test.lst ") != std::string::npos);
+    assert_true(time.find("\npeak_rss_kb = ") != std::string::npos);
+
+    FrontendSettings json;
+    json.timingJson = true;
+    time = test_report("nop; include \"inc.asm\"", &FrontendSettings::timingPath, json);
+    assert_int_equal(time.find("{\"phases\": [{\"name\": \"read\", \"file\": \"test.asm\", \"wall\": "), 0);
+    assert_true(time.find("{\"name\": \"pass 1\", \"file\": \"\"") != std::string::npos);
+    assert_true(time.find("], \"peak_rss_kb\": ") != std::string::npos);
+
+    // allocations by subsystem
+    auto mem = test_report("let l = [1, 2, 3]; db l; include \"inc.asm\"", &FrontendSettings::memStatsPath);
+    assert_int_equal(mem.find("other.allocations = "), 0);
+    auto counter = [&mem](std::string name) {
+        auto at = mem.find("\n" + name + " = ");
+        assert_true(at != std::string::npos);
+        return std::stoul(mem.substr(at + name.length() + 4));
+    };
+    if (MemTracker::isEnabled()) {
+        for (auto name : {"scanner", "parser", "environment", "values", "code", "writer"}) {
+            assert_true(counter(std::string(name) + ".allocations") > 0);
+            assert_true(counter(std::string(name) + ".peak_bytes") > 0);
+        }
+    } else {
+        assert_int_equal(counter("scanner.allocations"), 0);
+        assert_int_equal(counter("code.peak_bytes"), 0);
+    }
+
+    // chrome trace
+    auto trace = test_report("nop; include \"inc.asm\"", &FrontendSettings::tracePath);
+    assert_int_equal(trace.find("{\"traceEvents\": [{\"name\": \"read\", \"cat\": \"lasm\", \"ph\": \"X\", \"ts\": "), 0);
+    assert_true(trace.find("{\"name\": \"parse\", \"cat\": \"lasm\", \"ph\": \"X\"") != std::string::npos);
+    assert_true(trace.find("\"args\": {\"file\": \"inc.asm\"}}") != std::string::npos);
+    assert_true(trace.find("{\"name\": \"pass 2\"") != std::string::npos);
+    assert_true(trace.find("\"args\": {\"file\": \"test.lst\"}}], \"displayTimeUnit\": \"ms\"}\n") != std::string::npos);
+    // one span for every run of execute inc.asm
+    unsigned long executes = 0;
+    for (auto at = trace.find("\"execute\""); at != std::string::npos; at = trace.find("\"execute\"", at + 1)) {
+        executes++;
+    }
+    assert_int_equal(executes, 2);
 }
 
 void test_frontend_errors(void **state) {
@@ -151,4 +294,16 @@ void test_frontend_errors(void **state) {
     test_full_err("brl 32772;", InstructionSet65816, VALUE_OUT_OF_RANGE);
     test_full_err("adc (0x1f1f);", InstructionSet65816, VALUE_OUT_OF_RANGE);
     test_full_err("adc.i 0x1A;", InstructionSet65816, INVALID_INSTRUCTION);
+
+    // plugins that can not be loaded
+    {
+        auto reader = DummyReader("nop;");
+        auto writer = DummyWriter();
+        InstructionSet6502 instructions;
+        FrontendSettings settings;
+        settings.plugins.push_back("missing.so");
+        std::stringstream nopstream;
+        Frontend frontend(instructions, reader, writer, settings, nopstream);
+        assert_int_equal(frontend.assemble("test.asm", "test.bin"), PLUGIN_ERROR);
+    }
 }
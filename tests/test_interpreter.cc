@@ -3,6 +3,7 @@
 #include "parser.h"
 #include "instruction.h"
 #include "instruction6502.h"
+#include "plugin.h"
 #include <memory>
 
 #include "macros.h"
@@ -18,6 +19,19 @@ class TestCallback: public InterpreterCallback {
         std::shared_ptr<LasmObject> object = std::shared_ptr<LasmObject>(nullptr);
 };
 
+class XorBuffer: public BufferCallable {
+    public:
+        XorBuffer():
+            BufferCallable::BufferCallable(2) {}
+
+        virtual void transform(const unsigned char *data, unsigned long length,
+                Arguments &arguments, std::vector<unsigned char> &out) {
+            for (unsigned long i = 0; i < length; i++) {
+                out.push_back(data[i] ^ arguments[1].toNumber());
+            }
+        }
+};
+
 #define assert_interpreter_success(code, stmtSize, objType, ...) {\
     BaseError error;\
     InstructionSet6502 is;\
@@ -141,6 +155,221 @@ void test_interpreter(void **state) {
             3, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 5);});
     assert_interpreter_success("fn x() {} let a  = x(); a;", 3, NIL_O, {assert_null(callback.object->toNil());});
     assert_interpreter_success("fn x() {return;} let a  = x(); a;", 3, NIL_O, {assert_null(callback.object->toNil());});
+    assert_interpreter_success("fn x(a) { while (true) { if (a > 3) { return a; } a = a + 1; } } x(0);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 4);});
+    assert_interpreter_success("fn f(n) { if (n < 2) { return n; } return f(n-1) + f(n-2); } fn add(a, b) { return a + b; } add(f(10), add(f(2), 1));",
+            3, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 57);});
+    // tail calls run in constant stack depth
+    assert_interpreter_success("fn count(n, acc) { if (n == 0) { return acc; } return count(n-1, acc+1); } count(200000, 0);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 200000);});
+    assert_interpreter_success("fn even(n) { if (n == 0) { return true; } return odd(n-1); } fn odd(n) { if (n == 0) { return false; } return even(n-1); } even(100001);",
+            3, BOOLEAN_O, {assert_false(callback.object->toBool());});
+    // the callee of a tail call sees the locals of its caller
+    assert_interpreter_success("fn b() { return x; } fn a() { let x = 7; return b(); } a();",
+            3, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 7);});
+    assert_interpreter_success("fn f(n) { if (n == 0) { return y; } let y = n; return f(n-1); } f(3);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 1);});
+    assert_interpreter_success("fn x(a) { return lo(a); } x(0x1234);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 0x34);});
+
+    // constants
+    assert_interpreter_success("const a = 5; let b = 0; for (let i = 0; i < 10; i = i + 1) { b = b + a; } b;",
+            4, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 50);});
+    assert_interpreter_success("let b = 1; { const b = 2; } b;",
+            3, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 1);});
+    assert_interpreter_success("fn x() { return a; } const a = 3; x();",
+            3, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 3);});
+
+    // statements that are the same in every pass only run once
+    assert_interpreter_success("let a = 2; fn f(x) { return x * a; } const b = lo(a + 0x100); bss b { c 1, } f(c);",
+            5, NUMBER_O, {
+            assert_int_equal(callback.object->toNumber(), 4);
+            assert_int_equal(interpreter.getPrelude().size(), 4);
+            });
+    assert_interpreter_success("let a = 1; let b = _A(); let c = 3; c;",
+            4, NUMBER_O, {assert_int_equal(interpreter.getPrelude().size(), 1);});
+    assert_interpreter_success("let a = 1; let b = [a]; b[0] = 2; b[0];",
+            4, NUMBER_O, {
+            assert_int_equal(callback.object->toNumber(), 2);
+            assert_int_equal(interpreter.getPrelude().size(), 1);
+            });
+    assert_interpreter_success("let a = end; end: a;",
+            3, NUMBER_O, {assert_int_equal(interpreter.getPrelude().size(), 0);});
+
+    // memoization of pure functions
+    assert_interpreter_success("fn sq(x) { return x * x; } let a = 0; for (let i = 0; i < 10; i = i + 1) { a = a + sq(3); } a;",
+            4, NUMBER_O, {
+            assert_int_equal(callback.object->toNumber(), 90);
+            assert_int_equal(interpreter.getMemoMisses(), 1);
+            assert_int_equal(interpreter.getMemoHits(), 19);
+            });
+    // the outer sq is a tail call and is not looked up
+    assert_interpreter_success("fn sq(x) { return x * x; } fn quad(x) { return sq(sq(x)); } quad(2); quad(2);",
+            4, NUMBER_O, {
+            assert_int_equal(callback.object->toNumber(), 16);
+            assert_int_equal(interpreter.getMemoMisses(), 2);
+            assert_int_equal(interpreter.getMemoHits(), 3);
+            });
+    assert_interpreter_success("let g = 1; fn f(x) { return x + g; } f(1); g = 2; f(1);",
+            5, NUMBER_O, {
+            assert_int_equal(callback.object->toNumber(), 3);
+            assert_int_equal(interpreter.getMemoMisses() + interpreter.getMemoHits(), 0);
+            });
+    assert_interpreter_success("fn f(x) { lda #x; return x; } f(1); f(1);",
+            3, NUMBER_O, {assert_int_equal(interpreter.getMemoMisses() + interpreter.getMemoHits(), 0);});
+    assert_interpreter_success("fn f(x) { x[0] = 2; return x; } f([1]); f([1])[0];",
+            3, NUMBER_O, {assert_int_equal(interpreter.getMemoMisses() + interpreter.getMemoHits(), 0);});
+    assert_interpreter_success("let g = 1; pure fn f(x) { return x + g; } f(1); g = 2; f(1);",
+            5, NUMBER_O, {
+            assert_int_equal(callback.object->toNumber(), 2);
+            assert_int_equal(interpreter.getMemoMisses(), 1);
+            assert_int_equal(interpreter.getMemoHits(), 3);
+            });
+    // pure fn is ignored if the function emits code
+    assert_interpreter_success("pure fn f(x) { nop; return x; } f(1); f(1);",
+            3, NUMBER_O, {assert_int_equal(interpreter.getMemoMisses() + interpreter.getMemoHits(), 0);});
+
+    // expression values are reused while their variables do not change
+    assert_interpreter_success("let a = 2; nop; lo(a * 0x100 + 3);",
+            3, NUMBER_O, {
+            assert_int_equal(callback.object->toNumber(), 3);
+            assert_int_equal(interpreter.getExpressionCache().getMisses(), 1);
+            assert_int_equal(interpreter.getExpressionCache().getHits(), 1);
+            });
+    assert_interpreter_success("let b = 0; for (let i = 0; i < 3; i = i + 1) { b = i * 2; } b;",
+            3, NUMBER_O, {
+            assert_int_equal(callback.object->toNumber(), 4);
+            assert_int_equal(interpreter.getExpressionCache().getHits(), 0);
+            });
+    assert_interpreter_success("nop; _A() + 1;",
+            2, NUMBER_O, {
+            assert_int_equal(callback.object->toNumber(), 2);
+            assert_int_equal(interpreter.getExpressionCache().getHits(), 0);
+            });
+    assert_interpreter_success("let t = [1]; let c = 0; for (let i = 0; i < 2; i = i + 1) { c = (t[0]) * 2; t[0] = 5; } c;",
+            4, NUMBER_O, {
+            assert_int_equal(callback.object->toNumber(), 10);
+            assert_int_equal(interpreter.getExpressionCache().getHits(), 0);
+            });
+
+    // table generators
+    assert_interpreter_success("let t = sintable(4, 100); (t[1]);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 100);});
+    assert_interpreter_success("let t = costable(8, 64, 0, 128); (t[4]);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 64);});
+    assert_interpreter_success("let t = popcounttable(256); (t[0xF3]);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 6);});
+    assert_interpreter_success("let t = bitrevtable(256); (t[1]);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 0x80);});
+    assert_interpreter_success("let t = qsquaretable(512); (t[10]);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 25);});
+    assert_interpreter_success("let t = reciptable(256, 0x100); (t[3]);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 85);});
+    assert_interpreter_success("let t = crc16table(); (t[1]);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 0x1021);});
+    assert_interpreter_success("let t = crc32table(); (t[1]);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 0x77073096);});
+    // tables are packed in the smallest width unless they are signed
+    assert_interpreter_success("sintable(256, 127, 0, 128);",
+            1, BYTES_O, {assert_int_equal(callback.object->toBytes()->getWidth(), 1);});
+    assert_interpreter_success("qsquaretable(512);",
+            1, BYTES_O, {assert_int_equal(callback.object->toBytes()->getWidth(), 2);});
+    assert_interpreter_success("crc16table();",
+            1, BYTES_O, {assert_int_equal(callback.object->toBytes()->getWidth(), 2);});
+    assert_interpreter_success("crc32table();",
+            1, BYTES_O, {assert_int_equal(callback.object->toBytes()->getWidth(), 4);});
+    assert_interpreter_success("sintable(4, 100);", 1, LIST_O, {});
+    assert_code6502("db bitrevtable(4, 2);", 4, 0, {0, 2, 1, 3});
+    assert_code6502("dh sintable(4, 100);", 8, 0, {0, 0, 100, 0, 0, 0, (char)0x9C, (char)0xFF});
+    assert_interpreter_success("fixmul(fixed(1.5, 8), fixed(2, 8), 8);",
+            1, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 0x300);});
+    assert_interpreter_success("len(range(10));",
+            1, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 10);});
+    assert_interpreter_success("let t = range(10, 0, -3); (t[3]) + len(t);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 5);});
+    assert_code6502("db range(1, 4), 4;", 4, 0, {1, 2, 3, 4});
+    assert_code6502("dh [1, [2, 3]];", 6, 0, {1, 0, 2, 0, 3, 0});
+
+    // packed arrays
+    assert_interpreter_success("let b = bytes([1, 2, 0x1FF]); (b[2]);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 0xFF);});
+    assert_interpreter_success("let b = array16(3); b[1] = 0x12345; (b[1]);",
+            3, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 0x2345);});
+    assert_interpreter_success("len(bytes(\"hey\") + bytes(2));",
+            1, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 5);});
+    assert_interpreter_success("let b = slice(array32([1, 2, 3, 4]), 1, 2); len(b) + (b[1]);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 5);});
+    assert_interpreter_success("slice(\"Hello\", 1, 2);",
+            1, STRING_O, {assert_cc_string_equal(callback.object->toString(), std::string("el"));});
+    assert_interpreter_success("let b = bytes([1, 2, 3]); let s = slice(b, 1); s[0] = 9; (b[1]) * 10 + (s[0]);",
+            4, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 29);});
+    assert_code6502("db bytes([1, 2, 3]);", 3, 0, {1, 2, 3});
+    assert_code6502("dh array16([0x1234, 5]);", 4, 0, {0x34, 0x12, 5, 0});
+    assert_code6502("dw bytes(\"A\");", 4, 0, {'A', 0, 0, 0});
+
+    // lists
+    assert_interpreter_success("let l = []; for (let i = 0; i < 5; i = i + 1) { l = push(l, i); } len(l) + (l[4]);",
+            3, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 9);});
+    assert_interpreter_success("let a = [1]; let b = push(a, 2); let c = push(a, 3); len(a) * 100 + (b[1]) * 10 + (c[1]);",
+            4, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 123);});
+    assert_interpreter_success("let a = [1, 2]; let b = push(a, 3); b[0] = 9; (a[0]);",
+            4, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 1);});
+    assert_interpreter_success("let a = [1]; let b = a; b[0] = 2; (a[0]);",
+            4, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 2);});
+    assert_interpreter_success("len([1, 2] + [3]) + len(concat([1], [2, 3, 4]));",
+            1, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 7);});
+    assert_interpreter_success("let s = slice([1, 2, 3, 4], 1, 2); (s[0]) + len(s);",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 4);});
+
+    // dicts
+    assert_interpreter_success("let d = dict(); d[\"x\"] = 2; d[3] = 4; (d[\"x\"]) + (d[3]) + len(d);",
+            4, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 8);});
+    assert_interpreter_success("let d = dict([[1, 2], [\"a\", 3]]); has(d, \"a\") && !has(d, 2);",
+            2, BOOLEAN_O, {assert_true(callback.object->toBool());});
+    assert_interpreter_success("let d = dict(); (d[\"missing\"]);",
+            2, NIL_O, {});
+    assert_interpreter_success("let d = dict([[5, 0], [6, 0], [7, 0]]); remove(d, 5); let k = keys(d); (k[0]) * 10 + len(k);",
+            4, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 62);});
+    assert_interpreter_success("let d = dict(); for (let i = 0; i < 100; i = i + 1) { d[i & 7] = i; } len(d) + (d[7]);",
+            3, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 8 + 95);});
+    assert_interpreter_success("let d = dict(); for (let i = 0; i < 64; i = i + 1) { d[i] = i; } for (let i = 0; i < 60; i = i + 1) { remove(d, i); } (keys(d)[0]) + len(d);",
+            4, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 60 + 4);});
+
+    // strings
+    assert_interpreter_success("let s = \"\"; for (let i = 0; i < 1000; i = i + 1) { s = s + \"0123456789\"; } len(s);",
+            3, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 10000);});
+    assert_interpreter_success("let s = \"\"; for (let i = 0; i < 30; i = i + 1) { s = s + \"0123456789\"; } slice(s, 295, 5);",
+            3, STRING_O, {assert_cc_string_equal(callback.object->toString(), std::string("56789"));});
+    assert_interpreter_success("let s = \"\"; for (let i = 0; i < 30; i = i + 1) { s = s + \"0123456789\"; } let v = slice(s, 2, 288); (v[1]) + len(v);",
+            4, NUMBER_O, {assert_int_equal(callback.object->toNumber(), '3' + 288);});
+    assert_interpreter_success("join([\"a\", \"b\", \"c\"], \", \") == \"a, \" + \"b, c\";",
+            1, BOOLEAN_O, {assert_true(callback.object->toBool());});
+
+    // compression
+    assert_code6502("db pack_rle([7, 7, 7, 7, 1]);", 5, 0, {(char)0x82, 7, 0x00, 1, (char)0xFF});
+    assert_code6502("db pack_lz(\"abcdabcdabcd\");", 9, 0, {0x03, 'a', 'b', 'c', 'd', (char)0x85, 4, 0, (char)0xFF});
+    assert_interpreter_success("let p = pack_rle(bytes([1, 1, 1, 1, 1, 2, 3])); len(p) * 100 + len(unpack_rle(p));",
+            2, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 607);});
+    assert_interpreter_success("let data = bytes(sintable(256, 127, 0, 128) + reciptable(256, 0xFF)); "
+            "let u = unpack_lz(pack_lz(data)); let same = len(u) == len(data); "
+            "for (i in range(len(data))) { if ((u[i]) != (data[i])) { same = false; } } (same);",
+            5, BOOLEAN_O, {assert_true(callback.object->toBool());});
+    assert_interpreter_success("let t = pack_dte([\"the theme\", \"then the\"]); let x = t[\"text\"]; "
+            "len(t[\"table\"]) * 100 + len(x[0]) * 10 + len(x[1]);",
+            3, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 276);});
+
+    // for-in loops
+    assert_interpreter_success("let s = 0; for (i in range(5)) { s = s + i; } (s);",
+            3, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 10);});
+    assert_interpreter_success("let s = 0; for (x in [1, 2, 3]) { s = s * 10 + x; } (s);",
+            3, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 123);});
+    assert_interpreter_success("let s = 0; for (c in \"ab\") { s = s + c; } for (b in bytes([1, 2])) { s = s + b; } (s);",
+            4, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 'a' + 'b' + 3);});
+    assert_interpreter_success("let d = dict([[5, 0], [6, 0]]); let s = 0; for (k in d) { s = s * 10 + k; } (s);",
+            4, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 56);});
+    assert_interpreter_success("let r = range(3); r[0] = 7; let s = 0; for (x in r) { s = s + x; } (s);",
+            5, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 10);});
+    assert_code6502_a("for (x in range(2, 8, 2)) { db x; }", 1, 2, 2, {6});
 
     assert_interpreter_success("0x8283 & 0xFF;", 1, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 0x8283 & 0xFF);});
     assert_interpreter_success("0x8283 | 0xFF;", 1, NUMBER_O, {assert_int_equal(callback.object->toNumber(), 0x8283 | 0xFF);});
@@ -154,8 +383,17 @@ void test_interpreter(void **state) {
     assert_code6502("org 0x02; align 0x04, 0xFF;", 2, 2, {(char)0xFF, (char)0xFF});
     assert_code6502("org 0x02; fill 0x06, 0xFF;", 4, 2, {(char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF});
 
-    assert_code6502("db \"Hello\", 2, 3, true;", 6, 0, {'H', 'e', 'l', 'l', 'o', '\0', 0x02, 0x03, 1});
-    assert_code6502("dw 100, 100;", 4, 0, {0x64, 0, 0, 0, 0x64, 0, 0, 0});
+    assert_code6502("db \"Hello\", 2, 3, true;", 9, 0, {'H', 'e', 'l', 'l', 'o', '\0', 0x02, 0x03, 1});
+    assert_code6502("dw 100, 100;", 8, 0, {0x64, 0, 0, 0, 0x64, 0, 0, 0});
+    assert_code6502("dh 0x1234, -2, 3;", 6, 0, {0x34, 0x12, (char)0xFE, (char)0xFF, 3, 0});
+    assert_code6502("db 1, 2, 3; db 4;", 3, 0, {1, 2, 3});
+    assert_code6502_a("db 1, 2, 3; db 4;", 1, 3, 1, {4});
+    assert_code6502("db 1, 2 + 1, 3;", 3, 0, {1, 3, 3});
+    assert_code6502("db 1, _A();", 2, 0, {1, 1});
+    assert_code6502("dw 1.5, 2;", 8, 0, {0, 0, (char)0xC0, 0x3F, 2, 0, 0, 0});
+    assert_code6502_a("fn m() { nop; return 5; } db 1, m(), 2;", 1, 0, 0, {1});
+    assert_code6502_a("fn m() { nop; return 5; } db 1, m(), 2;", 1, 1, 1, {(char)0xEA});
+    assert_code6502_a("fn m() { nop; return 5; } db 1, m(), 2;", 2, 2, 2, {5, 2});
     assert_code6502("dh 100;", 2, 0, {0x64, 0});
     assert_code6502("dd 100;", 8, 0, {0x64, 0, 0, 0, 0, 0, 0, 0, 0});
 
@@ -263,7 +501,48 @@ void test_interpreter_errors(void **state) {
 
     assert_interpreter_error("fn x(a, b) {} let a  = x(1);", 2, ARITY_ERROR);
     assert_interpreter_error("fn x(a, b) {} let a  = x(1, 2, 3);", 2, ARITY_ERROR);
+    assert_interpreter_error("let b = bytes(2); b[2];", 2, INDEX_OUT_OF_BOUNDS);
+    assert_interpreter_error("let b = bytes(2); b[0] = \"a\";", 2, TYPE_ERROR);
+    assert_interpreter_error("bytes(1 << 40);", 1, VALUE_OUT_OF_RANGE);
+    assert_interpreter_error("array32(1 << 62);", 1, VALUE_OUT_OF_RANGE);
+    assert_interpreter_error("bytes(true);", 1, TYPE_ERROR);
+    assert_interpreter_error("bytes([\"a\"]);", 1, TYPE_ERROR);
+    assert_interpreter_error("bytes(1) + 1;", 1, TYPE_ERROR);
+    assert_interpreter_error("push(1, 2);", 1, TYPE_ERROR);
+    assert_interpreter_error("concat([1], bytes(1));", 1, TYPE_ERROR);
+    assert_interpreter_error("let d = dict(); d[[1]] = 2;", 2, TYPE_ERROR);
+    assert_interpreter_error("has(1, 2);", 1, TYPE_ERROR);
+    assert_interpreter_error("dict([1]);", 1, TYPE_ERROR);
+    assert_interpreter_error("range();", 1, ARITY_ERROR);
+    assert_interpreter_error("range(1, 2, 3, 4);", 1, ARITY_ERROR);
+    assert_interpreter_error("range(1, 2, 0);", 1, VALUE_OUT_OF_RANGE);
+    assert_interpreter_error("for (x in 1) { }", 1, TYPE_ERROR);
+    assert_interpreter_error("pack_rle(1);", 1, TYPE_ERROR);
+    assert_interpreter_error("unpack_lz(bytes([0x80, 5, 0, 0xFF]));", 1, VALUE_OUT_OF_RANGE);
+    assert_interpreter_error("unpack_rle(bytes([0x02, 1]));", 1, VALUE_OUT_OF_RANGE);
+    assert_interpreter_error("pack_dte(\"abc\", 0x61);", 1, VALUE_OUT_OF_RANGE);
+    assert_interpreter_error("for (x in range(2)) { } x;", 2, UNDEFINED_REF);
+    assert_interpreter_error("const x = 1; for (x in range(2)) { }", 2, CONST_REDEFINITION);
+    assert_interpreter_error("sintable(\"a\", 1);", 1, TYPE_ERROR);
+    assert_interpreter_error("bitrevtable(4, 33);", 1, VALUE_OUT_OF_RANGE);
     assert_parser_error("fn x a, b) {} x(1, 2);", MISSING_LEFT_PAREN);
+    assert_parser_error("fn x() { nop;", BLOCK_NOT_CLOSED_ERROR);
+
+    // function bodies are parsed when they are called first
+    assert_code6502("fn x() { 1 + ; } nop;", 1, 0, {(char)0xEA});
+    assert_interpreter_error("fn x() { 1 + ; } x();", 2, EXPECTED_EXPRESSION);
+    assert_code6502_a("fn x(v) { if (v) { fn y() { nop; } y(); } } x(true);", 1, 0, 0, {(char)0xEA});
+    assert_parser_error("pure x() {}", MISSING_FUNCTION);
+
+    assert_parser_error("const a;", CONST_WITHOUT_VALUE);
+    assert_interpreter_error("const a = 1; a = 2;", 2, CONST_ASSIGNMENT);
+    assert_interpreter_error("const a = 1; { a = 2; }", 2, CONST_ASSIGNMENT);
+    assert_interpreter_error("const a = 1; let a = 2;", 2, CONST_REDEFINITION);
+    assert_interpreter_error("const a = 1; { let a = 2; }", 2, CONST_REDEFINITION);
+    assert_interpreter_error("const a = 1; fn a() {}", 2, CONST_REDEFINITION);
+    assert_interpreter_error("const a = 1; fn x(a) {} x(1);", 3, CALLSTACK_UNWIND);
+    assert_interpreter_error("{ const a = 1; a = 2; }", 1, CONST_ASSIGNMENT);
+    assert_interpreter_error("{ const a = 1; let a = 2; }", 1, CONST_REDEFINITION);
 
     assert_parser_error("org", EXPECTED_EXPRESSION);
     assert_parser_error("align", EXPECTED_EXPRESSION);
@@ -321,6 +600,30 @@ void test_interpreter_errors(void **state) {
 }
 
 void test_misc_interpreter(void **state) {
+    // builtins defined by plugins
+    {
+        BaseError error;
+        InstructionSet6502 is;
+        TestCallback callback;
+        Scanner scanner(error, is, "let b = xor(slice(bytes([1, 2, 3]), 1), 0xF0); (b[0]) + (b[1]) * 0x100 + len(xor(\"ab\", 0)) * 0x10000;", "");
+        auto tokens = scanner.scanTokens();
+        Parser parser(error, tokens, is);
+        auto stmts = parser.parse();
+        Interpreter interpreter(error, is, &callback);
+        PluginRegistry registry(interpreter);
+        registry.define<XorBuffer>("xor");
+        interpreter.interprete(stmts);
+        assert_int_equal(error.getType(), NO_ERROR);
+        assert_int_equal(callback.object->toNumber(), 0xF2 + 0xF3 * 0x100 + 2 * 0x10000);
+    }
+
+    // plugins built with other configure options have another version
+#ifdef LASM_STATS
+    assert_int_not_equal(LASM_PLUGIN_VERSION & LASM_PLUGIN_STATS, 0);
+#else
+    assert_int_equal(LASM_PLUGIN_VERSION & LASM_PLUGIN_STATS, 0);
+#endif
+
     InstructionInfo result(nullptr);
     result.addOpcode(0xF1, "test");
     assert_true(result.hasOpcode("test"));
@@ -1,5 +1,6 @@
 #include "object.h"
 #include "error.h"
+#include "bytearray.h"
 #include "test_object.h"
 
 
@@ -36,6 +37,45 @@ void test_object(void **state) {
     lasm::LasmObject num2(lasm::NUMBER_O, lasm::lasmNumber(345));
     assert_false(num.isEqual(num2));
 
+    // strings are interned
+    lasm::LasmObject str2(lasm::STRING_O, std::string("Test"));
+    assert_ptr_equal(str.toLasmString().get(), str2.toLasmString().get());
+    assert_true(str.isEqual(str2));
+    assert_int_equal(str.hash(), str2.hash());
+
+    // long concatenations are ropes until they are read
+    auto rope = lasm::LasmString::make(std::string(200, 'a'));
+    for (int i = 0; i < 1000; i++) {
+        rope = lasm::LasmString::concat(rope, lasm::LasmString::make("b"));
+    }
+    assert_int_equal(rope->length(), 1200);
+    assert_int_equal(rope->get().length(), 1200);
+    assert_ptr_equal(rope->canonical(), lasm::LasmString::make(rope->get()).get());
+
+    // long slices point into the original
+    auto view = lasm::LasmString::slice(lasm::LasmString::slice(rope, 100, 1100), 50, 400);
+    assert_int_equal(view->length(), 350);
+    assert_int_equal(view->at(0), 'a');
+    assert_int_equal(view->at(349), 'b');
+    assert_cc_string_equal(view->get(), rope->get().substr(150, 350));
+
+    // array slices are copied when written to
+    auto array = std::make_shared<lasm::ByteArray>("Hello", 5);
+    auto part = array->slice(1, 3);
+    part->set(0, 'a');
+    assert_int_equal(part->get(0), 'a');
+    assert_int_equal(part->get(1), 'l');
+    assert_int_equal(array->get(1), 'e');
+
+    // arrays that can not be addressed are rejected instead of wrapping around
+    bool rejected = false;
+    try {
+        lasm::ByteArray huge(4, 1UL << 62);
+    } catch (std::length_error &e) {
+        rejected = true;
+    }
+    assert_true(rejected);
+
     // scalar
     assert_false(str.isScalar());
     assert_true(num.isScalar());
@@ -0,0 +1,92 @@
+#include "optimizer.h"
+#include "parser.h"
+#include "scanner.h"
+#include "instruction6502.h"
+#include "astprinter.h"
+
+#include "test_optimizer.h"
+#include "macros.h"
+
+using namespace lasm;
+
+#define optimize_code(code) \
+    BaseError error;\
+    InstructionSet6502 is;\
+    Scanner scanner(error, is, code, std::string("test"));\
+    auto tokens = scanner.scanTokens();\
+    Parser parser(error, tokens, is);\
+    auto stmts = parser.parse();\
+    assert_false(error.didError());\
+    Optimizer optimizer(error, is);\
+    optimizer.optimize(stmts);\
+    assert_false(error.didError());
+
+#define assert_folded(code, expected) {\
+    optimize_code(code);\
+    assert_int_equal(stmts.size(), 1);\
+    assert_int_equal(stmts[0]->getType(), EXPRESSION_STMT);\
+    auto exprStmt = static_cast<ExpressionStmt*>(stmts[0].get());\
+    AstPrinter astPrinter;\
+    assert_cc_string_equal(astPrinter.toString(exprStmt->expr.get()), std::string(expected));\
+}
+
+void test_optimizer(void **state) {
+    assert_folded("(0x2000 + 0x10) << 2;", "32832");
+    assert_folded("1 + 2 * (1 - 5 + 2) == -1;", "false");
+    assert_folded("\"Hello\" + \" World\";", "Hello World");
+    assert_folded("true || 1 / 0;", "true");
+    assert_folded("false || 1 / 0;", "(/ 1 0)");
+
+    // errors are left to the interpreter
+    assert_folded("1 / 0;", "(/ 1 0)");
+    assert_folded("(1 + 1) + \"a\";", "(+ 2 a)");
+
+    {
+        optimize_code("if (1 == 2) { lda #1; } else { lda #2; } while (false) { nop; } if (false) { nop; } nop;");
+        assert_int_equal(stmts.size(), 2);
+        assert_int_equal(stmts[0]->getType(), BLOCK_STMT);
+        assert_int_equal(stmts[1]->getType(), INSTRUCTION_STMT);
+    }
+
+    {
+        // single statements are replaced by empty blocks
+        optimize_code("if (x) if (0 > 1) nop;");
+        assert_int_equal(stmts.size(), 1);
+        auto ifStmt = static_cast<IfStmt*>(stmts[0].get());
+        assert_int_equal(ifStmt->thenBranch->getType(), BLOCK_STMT);
+        assert_int_equal(static_cast<BlockStmt*>(ifStmt->thenBranch.get())->statements.size(), 0);
+    }
+
+    {
+        // global constants are inlined after they were declared
+        optimize_code("a + 1; const a = 2; a + 1; { a; }");
+        AstPrinter astPrinter;
+        assert_int_equal(static_cast<ExpressionStmt*>(stmts[0].get())->expr->getType(), BINARY_EXPR);
+        assert_cc_string_equal(astPrinter.toString(static_cast<ExpressionStmt*>(stmts[2].get())->expr.get()),
+                std::string("3"));
+        auto block = static_cast<BlockStmt*>(stmts[3].get());
+        assert_int_equal(static_cast<ExpressionStmt*>(block->statements[0].get())->expr->getType(), LITERAL_EXPR);
+    }
+
+    {
+        optimize_code("{ const a = 2; } a;");
+        assert_int_equal(static_cast<ExpressionStmt*>(stmts[1].get())->expr->getType(), VARIABLE_EXPR);
+    }
+
+    {
+        optimize_code("fn x() { lda #(1 + 2); }");
+        auto fn = static_cast<FunctionStmt*>(stmts[0].get());
+        auto instruction = static_cast<InstructionStmt*>(fn->getBody()[0].get());
+        assert_int_equal(instruction->args[0]->getType(), LITERAL_EXPR);
+    }
+
+    {
+        // bodies are parsed on first use and still see earlier constants
+        optimize_code("const c = 2; fn x() { lda #c; } const d = 3;");
+        auto fn = static_cast<FunctionStmt*>(stmts[1].get());
+        assert_non_null(fn->lazyBody.get());
+        auto instruction = static_cast<InstructionStmt*>(fn->getBody()[0].get());
+        assert_null(fn->lazyBody.get());
+        assert_int_equal(instruction->args[0]->getType(), LITERAL_EXPR);
+    }
+}
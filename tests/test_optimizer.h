@@ -0,0 +1,6 @@
+#ifndef __TEST_OPTIMIZER_H__
+#define __TEST_OPTIMIZER_H__
+
+void test_optimizer(void **state);
+
+#endif